@@ -53,6 +53,20 @@ void set_plane_position(uint16_t canvas_struct_address, uint16_t x_position, uin
 void erase_buffer(uint16_t buffer_data_address);
 void erase_buffer_sized(uint16_t buffer_data_address, uint16_t width, uint16_t height, uint8_t bpp);
 
+void copy_xram(uint16_t src_addr, uint16_t dst_addr, uint16_t len);
+void copy_rect_xram(uint16_t src_addr, uint16_t src_pitch,
+                    uint16_t dst_addr, uint16_t dst_pitch,
+                    uint16_t row_bytes, uint16_t rows);
+
+// 4bpp rectangle copies between buffers and to/from a save area
+void blit_rect(uint16_t src_buffer, uint16_t sx, uint16_t sy,
+               uint16_t dst_buffer, uint16_t dx, uint16_t dy,
+               uint16_t w, uint16_t h);
+uint16_t save_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                   uint16_t buffer_data_address, uint16_t save_addr);
+void restore_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                  uint16_t buffer_data_address, uint16_t save_addr);
+
 // ---------------------------------------------------------------------------
 // Drawing primitives (auto-detect plane from buffer address)
 // ---------------------------------------------------------------------------
@@ -263,6 +263,103 @@ void erase_buffer(uint16_t buffer_data_address)
     }
 }
 
+// ---------------------------------------------------------------------------
+// XRAM to XRAM copies: port 0 reads the source while port 1 writes the
+// destination, both auto-incrementing, so no address is reloaded per byte
+// ---------------------------------------------------------------------------
+void copy_xram(uint16_t src_addr, uint16_t dst_addr, uint16_t len)
+{
+    RIA.addr0 = src_addr;
+    RIA.step0 = 1;
+    RIA.addr1 = dst_addr;
+    RIA.step1 = 1;
+
+    uint16_t chunks = len >> 3;
+    for (uint16_t i = 0; i < chunks; i++) {
+        RIA.rw1 = RIA.rw0; RIA.rw1 = RIA.rw0; RIA.rw1 = RIA.rw0; RIA.rw1 = RIA.rw0;
+        RIA.rw1 = RIA.rw0; RIA.rw1 = RIA.rw0; RIA.rw1 = RIA.rw0; RIA.rw1 = RIA.rw0;
+    }
+
+    uint8_t remaining = len & 7;
+    while (remaining--) {
+        RIA.rw1 = RIA.rw0;
+    }
+}
+
+// Copy a rectangle of rows x row_bytes between buffers of any pitch (bytes per row)
+void copy_rect_xram(uint16_t src_addr, uint16_t src_pitch,
+                    uint16_t dst_addr, uint16_t dst_pitch,
+                    uint16_t row_bytes, uint16_t rows)
+{
+    if (src_pitch == row_bytes && dst_pitch == row_bytes) {
+        copy_xram(src_addr, dst_addr, row_bytes * rows);
+        return;
+    }
+    for (uint16_t r = 0; r < rows; r++) {
+        copy_xram(src_addr, dst_addr, row_bytes);
+        src_addr += src_pitch;
+        dst_addr += dst_pitch;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 4bpp rectangle blits. Horizontal edges are widened to whole bytes, so a
+// rectangle at an odd x also carries the neighbouring pixel along, and
+// blit_rect() expects sx and dx to have the same parity.
+// ---------------------------------------------------------------------------
+static bool rect_bytes(const PlaneConfig* plane, uint16_t x, uint16_t y,
+                       uint16_t *w, uint16_t *h, uint16_t *row_bytes)
+{
+    if (!plane || plane->bpp_mode != 2) return false;
+    if (x >= plane->width || y >= plane->height) return false;
+    if (x + *w > plane->width) *w = plane->width - x;
+    if (y + *h > plane->height) *h = plane->height - y;
+    *row_bytes = ((x + *w + 1) >> 1) - (x >> 1);
+    return true;
+}
+
+void blit_rect(uint16_t src_buffer, uint16_t sx, uint16_t sy,
+               uint16_t dst_buffer, uint16_t dx, uint16_t dy,
+               uint16_t w, uint16_t h)
+{
+    PlaneConfig* src = infer_plane_from_buffer(src_buffer);
+    PlaneConfig* dst = infer_plane_from_buffer(dst_buffer);
+    uint16_t row_bytes;
+    if (!dst || !rect_bytes(src, sx, sy, &w, &h, &row_bytes)) return;
+    if (!rect_bytes(dst, dx, dy, &w, &h, &row_bytes)) return;
+
+    copy_rect_xram(src_buffer + get_row_offset(src, sy) + (sx >> 1), src->bytes_per_row,
+                   dst_buffer + get_row_offset(dst, dy) + (dx >> 1), dst->bytes_per_row,
+                   row_bytes, h);
+}
+
+// Copy a rectangle of the buffer out to save_addr, packed row after row.
+// Returns the number of bytes used.
+uint16_t save_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                   uint16_t buffer_data_address, uint16_t save_addr)
+{
+    PlaneConfig* plane = infer_plane_from_buffer(buffer_data_address);
+    uint16_t row_bytes;
+    if (!rect_bytes(plane, x, y, &w, &h, &row_bytes)) return 0;
+
+    copy_rect_xram(buffer_data_address + get_row_offset(plane, y) + (x >> 1), plane->bytes_per_row,
+                   save_addr, row_bytes, row_bytes, h);
+    return row_bytes * h;
+}
+
+// Put back a rectangle saved with the same arguments by save_rect()
+void restore_rect(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                  uint16_t buffer_data_address, uint16_t save_addr)
+{
+    PlaneConfig* plane = infer_plane_from_buffer(buffer_data_address);
+    uint16_t row_bytes;
+    if (!rect_bytes(plane, x, y, &w, &h, &row_bytes)) return;
+
+    copy_rect_xram(save_addr, row_bytes,
+                   buffer_data_address + get_row_offset(plane, y) + (x >> 1), plane->bytes_per_row,
+                   row_bytes, h);
+}
+
 // ---------------------------------------------------------------------------
 // Draw pixel - uses plane 0 by default (for backward compatibility)
 // ---------------------------------------------------------------------------
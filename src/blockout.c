@@ -6,8 +6,6 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <fcntl.h>      // For open() flags
-#include <unistd.h>     // For open(), close(), read(), write()
 #include "colors.h"
 #include "usb_hid_keys.h"
 #include "bitmap_graphics_db.h"
@@ -16,9 +14,13 @@
 #include "blockout_shapes.h"
 #include "blockout_pit.h"
 #include "blockout_render.h"
+#include "blockout_dlist.h"
 #include "blockout_state.h"
 #include "blockout_input.h"
 #include "blockout_demo.h"
+#include "blockout_random.h"
+#include "blockout_assets.h"
+#include "blockout_profile.h"
 #include "sound.h"
 
 /* ================= CONFIG ================= */
@@ -27,9 +29,10 @@
 uint8_t PIT_WIDTH = 5;
 uint8_t PIT_DEPTH = 5;
 uint8_t PIT_HEIGHT = 8;
-uint8_t selected_pit_size = 2; // Default to 5x5 (1=4x4, 2=5x5)
+uint8_t selected_pit_size = 2; // Default to 5x5, see pit_presets
 
-uint8_t LEVEL_INDICATOR_HEIGHT = SCREEN_HEIGHT - LEVEL_INDICATOR_WIDTH * MAX_PIT_HEIGHT;
+uint8_t level_indicator_step = LEVEL_INDICATOR_SPAN / 8;
+uint8_t LEVEL_INDICATOR_HEIGHT = SCREEN_HEIGHT - LEVEL_INDICATOR_SPAN;
 
 
 uint32_t score = 0;
@@ -47,7 +50,8 @@ uint16_t seed = 0;
 uint8_t active_buffer = 0;
 
 bool perspective_enabled = true;
-uint8_t zoom_level = 0;
+bool shadow_enabled = true;
+uint8_t zoom_level = ZOOM_DEFAULT;
 uint8_t mode = 0;
 char text_buffer[24];
 uint8_t current_shape_idx = 0;
@@ -56,6 +60,7 @@ static uint16_t viewport_buffers[2] = {
     VIEWPORT_BUFFER_0, VIEWPORT_BUFFER_1
 };
 static bool start_screen_drawn = false;
+static bool game_over_banner_shown = false;
 static uint8_t shake_timer = 0;
 static uint8_t shake_index = 0;
 static const int8_t shake_offsets_standard[][2] = {
@@ -77,28 +82,144 @@ void mark_hud_dirty(void) {
     }
 }
 
-void apply_selected_pit_size(void) {
-    switch (selected_pit_size) {
-        case 1: // 4x4
-            PIT_WIDTH = 4;
-            PIT_DEPTH = 4;
-            PIT_HEIGHT = 8;
+// Pit presets for the number keys: width, depth, height
+static const uint8_t pit_presets[NUM_PIT_PRESETS][3] = {
+    {3, 3, 10},  // [1]
+    {4, 4, 8},   // [2]
+    {5, 5, 8},   // [3]
+    {7, 7, 12},  // [4]
+};
+
+// Everything that depends only on the pit dimensions, apart from the
+// grid tables and the static buffer. A resized pit starts empty.
+static void set_pit_dimensions(void) {
+    if (selected_pit_size < NUM_PIT_PRESETS) {
+        PIT_WIDTH = pit_presets[selected_pit_size][0];
+        PIT_DEPTH = pit_presets[selected_pit_size][1];
+        PIT_HEIGHT = pit_presets[selected_pit_size][2];
+    }
+    level_indicator_step = LEVEL_INDICATOR_SPAN / PIT_HEIGHT;
+    LEVEL_INDICATOR_HEIGHT = SCREEN_HEIGHT - level_indicator_step * PIT_HEIGHT;
+    pit_clear();
+    // Cube size follows the grid, so the shape cache is stale
+    last_orient = 255;
+}
+
+// Resizing from the start screen or zooming rebuilds the static buffer a
+// slice per frame: the viewport is cleared in bands, then each grid
+// layer's ring is drawn, then the walls, then one layer of settled cubes
+// at a time from the back, then the HUD.
+enum {
+    REBUILD_IDLE,
+    REBUILD_CLEAR,
+    REBUILD_LAYERS,
+    REBUILD_WALLS,
+    REBUILD_BLOCKS,
+    REBUILD_HUD
+};
+#define REBUILD_CLEAR_ROWS 20
+
+static uint8_t rebuild_stage = REBUILD_IDLE;
+static uint8_t rebuild_step = 0;
+
+static void begin_static_rebuild(void) {
+    select_grid_tables();
+    rebuild_stage = REBUILD_CLEAR;
+    rebuild_step = 0;
+}
+
+static void begin_pit_rebuild(void) {
+    set_pit_dimensions();
+    begin_static_rebuild();
+}
+
+static void pit_rebuild_step(void) {
+    switch (rebuild_stage) {
+        case REBUILD_CLEAR:
+            fill_rect2buffer(BLACK, VIEWPORT_X, rebuild_step, VIEWPORT_WIDTH, REBUILD_CLEAR_ROWS, STATIC_BUFFER_ADDR);
+            rebuild_step += REBUILD_CLEAR_ROWS;
+            if (rebuild_step >= VIEWPORT_HEIGHT) {
+                fill_rect2buffer(0, 3, 27, 18, 150, STATIC_BUFFER_ADDR);
+                rebuild_stage = REBUILD_LAYERS;
+                rebuild_step = 0;
+            }
             break;
-        case 2: // 5x5
-        default:
-            PIT_WIDTH = 5;
-            PIT_DEPTH = 5;
-            PIT_HEIGHT = 8;
+        case REBUILD_LAYERS:
+            draw_pit_ring(rebuild_step);
+            if (++rebuild_step > PIT_HEIGHT) {
+                rebuild_stage = REBUILD_WALLS;
+            }
+            break;
+        case REBUILD_WALLS:
+            draw_pit_walls();
+            rebuild_stage = REBUILD_BLOCKS;
+            rebuild_step = PIT_HEIGHT;
+            break;
+        case REBUILD_BLOCKS:
+            while (rebuild_step > 0 && is_layer_empty(rebuild_step - 1)) rebuild_step--;
+            if (rebuild_step > 0) {
+                draw_settled_layer(--rebuild_step);
+            }
+            if (rebuild_step == 0) {
+                rebuild_stage = REBUILD_HUD;
+            }
+            break;
+        case REBUILD_HUD:
+            // The HUD and level indicator go out with the next static update
+            mark_hud_dirty();
+            rebuild_stage = REBUILD_IDLE;
             break;
     }
+    dl_flush();
+}
 
-    LEVEL_INDICATOR_HEIGHT = SCREEN_HEIGHT - LEVEL_INDICATOR_WIDTH * PIT_HEIGHT;
-    precompute_grid_coordinates();
+// Apply the selected size at once, leaving the static buffer to a full
+// redraw. Used when a game or the demo starts.
+void apply_selected_pit_size(void) {
+    set_pit_dimensions();
+    select_grid_tables();
+    rebuild_stage = REBUILD_IDLE;
+    rebuild_column_tops();
     mark_hud_dirty();
     state.full_redraw_pending = true;
     state.need_static_redraw = true;
 }
 
+static void select_pit_preset(uint8_t preset) {
+    selected_pit_size = preset;
+    begin_pit_rebuild();
+}
+
+// Step one pit dimension within [lo, hi]
+static void adjust_pit_dimension(uint8_t *dim, int8_t delta, uint8_t lo, uint8_t hi) {
+    uint8_t value = *dim + delta;
+    demo_notify_start_screen_input();
+    if (value < lo || value > hi) return;
+    *dim = value;
+    selected_pit_size = PIT_SIZE_CUSTOM;
+    begin_pit_rebuild();
+}
+
+// Switch between the perspective and the oblique view. The oblique view
+// projects with shifts and adds and fills top faces as rectangles, which
+// keeps crowded pits fast.
+static void toggle_view(void) {
+    perspective_enabled = !perspective_enabled;
+    select_grid_tables();
+    last_orient = 255;
+    state.full_redraw_pending = true;
+    state.need_static_redraw = true;
+}
+
+// Step the perspective zoom. The grid for the new level comes from the
+// zoom cache and the static buffer is redrawn over the next frames.
+static void change_zoom(int8_t delta) {
+    uint8_t level = zoom_level + delta;
+    if (!perspective_enabled || level >= NUM_ZOOM_LEVELS || !zoom_fits(level)) return;
+    zoom_level = level;
+    begin_static_rebuild();
+}
+
 static const uint8_t shape_colors[7] = {
     RED, YELLOW, CYAN, GREEN, MAGENTA, BLUE, LIGHT_GRAY
 };
@@ -117,27 +238,30 @@ void draw_start_screen(uint16_t buf) {
     uint16_t front_buffer = viewport_buffers[active_buffer];
     uint16_t back_buffer = viewport_buffers[!active_buffer];
 
-    int fd = open("ROM:start_screen", O_RDONLY);
-    if (fd >= 0) {
-        int bytes_read = read_xram(front_buffer, VIEWPORT_SIZE, fd);
-        if (bytes_read >= 0) {
-            lseek(fd, 0, SEEK_SET);
-            read_xram(back_buffer, VIEWPORT_SIZE, fd);
-        } else {
-            printf("ERROR: read_xram failed %i\n\n", bytes_read);
-        }
-        close(fd);
-    } else {
-        printf("ERROR: reading ROM:start_screen %i\n\n", fd);
+    // Unpack once, then duplicate so a buffer flip still shows the screen
+    if (load_rle_xram("ROM:start_screen", front_buffer, VIEWPORT_SIZE)) {
+        copy_xram(front_buffer, back_buffer, VIEWPORT_SIZE);
     }
 
     switch_buffer_plane(VIEWPORT_STRUCT_ADDR, front_buffer);
 
 }
 
+// Banner rectangles; what they cover is saved to scratch XRAM first so
+// taking a banner down is a rectangle copy rather than a redraw
+#define PAUSE_BANNER_X 24
+#define PAUSE_BANNER_Y 30
+#define PAUSE_BANNER_W 135
+#define PAUSE_BANNER_H 28
+#define GAME_OVER_BANNER_X 88
+#define GAME_OVER_BANNER_Y 145
+#define GAME_OVER_BANNER_W 80
+#define GAME_OVER_BANNER_H 30
+
 void draw_pause_screen(uint16_t buf) {
 
-    fill_rect2buffer(DARK_GRAY, 24, 30, 135, 28, buf);
+    save_rect(PAUSE_BANNER_X, PAUSE_BANNER_Y, PAUSE_BANNER_W, PAUSE_BANNER_H, buf, PAUSE_SAVE_ADDR);
+    fill_rect2buffer(DARK_GRAY, PAUSE_BANNER_X, PAUSE_BANNER_Y, PAUSE_BANNER_W, PAUSE_BANNER_H, buf);
     set_text_multiplier(1);
     set_text_color(DARK_RED);
 
@@ -146,6 +270,10 @@ void draw_pause_screen(uint16_t buf) {
     draw_string2buffer(text_buffer, buf);
 }
 
+void hide_pause_screen(uint16_t buf) {
+    restore_rect(PAUSE_BANNER_X, PAUSE_BANNER_Y, PAUSE_BANNER_W, PAUSE_BANNER_H, buf, PAUSE_SAVE_ADDR);
+}
+
 void reset_game_state(void) {
     score = 0;
     lines_cleared = 0;
@@ -154,17 +282,11 @@ void reset_game_state(void) {
     drop_delay = 60;
     current_shape_idx = 0;
     next_shape_idx = 0;
-    angleX = angleY = angleZ = 0;
-    targetX = targetY = targetZ = 0;
-
-    for (uint8_t z = 0; z < MAX_PIT_HEIGHT; z++) {
-        for (uint8_t y = 0; y < MAX_PIT_DEPTH; y++) {
-            for (uint8_t x = 0; x < MAX_PIT_WIDTH; x++) {
-                pit[z][y][x] = 0;
-                pit_colors[z][y][x] = 0;
-            }
-        }
-    }
+    apply_rotation(0);
+    rng_seed(seed);
+    start_music();
+
+    pit_clear();
 
     mark_hud_dirty();
     state.full_redraw_pending = true;
@@ -183,7 +305,6 @@ void draw_static_hud(uint16_t buf) {
     static uint8_t last_pit_d = 0xFFu;
     static uint8_t last_pit_h = 0xFFu;
     static uint8_t last_level = 0xFFu;
-    static bool last_game_over = false;
 
     set_text_multiplier(1);
 
@@ -239,29 +360,39 @@ void draw_static_hud(uint16_t buf) {
     }
 
     if (state.current == STATE_GAME_OVER) {
-        if (!last_game_over) {
+        if (!game_over_banner_shown) {
+            save_rect(GAME_OVER_BANNER_X, GAME_OVER_BANNER_Y, GAME_OVER_BANNER_W, GAME_OVER_BANNER_H,
+                      buf, GAME_OVER_SAVE_ADDR);
             set_text_color(RED);
-            fill_rect2buffer(DARK_BLUE, 88, 145, 80, 30, buf);
+            fill_rect2buffer(DARK_BLUE, GAME_OVER_BANNER_X, GAME_OVER_BANNER_Y,
+                             GAME_OVER_BANNER_W, GAME_OVER_BANNER_H, buf);
             set_cursor(98, 150);
             draw_string2buffer("GAME OVER!", buf);
             set_cursor(96, 160);
             draw_string2buffer("[R] RESTART", buf);
         }
-        last_game_over = true;
-    } else if (last_game_over) {
-        // Full redraw will clear the banner and restore pit lines
-        last_game_over = false;
+        game_over_banner_shown = true;
+    } else if (game_over_banner_shown) {
+        restore_rect(GAME_OVER_BANNER_X, GAME_OVER_BANNER_Y, GAME_OVER_BANNER_W, GAME_OVER_BANNER_H,
+                     buf, GAME_OVER_SAVE_ADDR);
+        game_over_banner_shown = false;
     }
 }
 
 
 void update_static_buffer(void) {
     if (state.full_redraw_pending) {
-        fill_rect2buffer(BLACK, VIEWPORT_X, 0, VIEWPORT_WIDTH, VIEWPORT_HEIGHT, STATIC_BUFFER_ADDR);
+        // A full redraw supersedes a resize still being sliced in
+        rebuild_stage = REBUILD_IDLE;
         fill_rect2buffer(0, 3, 27, 18, 150, STATIC_BUFFER_ADDR);
-        draw_pit_background(STATIC_BUFFER_ADDR);
-        draw_settled_blocks(STATIC_BUFFER_ADDR);
+        // The clear and walls go out in one pass, then a pass per layer
+        dl_clear_viewport();
+        draw_pit_background();
+        dl_flush();
+        draw_settled_blocks();
         state.full_redraw_pending = false;
+        // The banner went with the old pit; redraw and resave it on top
+        game_over_banner_shown = false;
         mark_hud_dirty();
     }
     if (hud_dirty) {
@@ -320,23 +451,20 @@ void handle_start_screen_state(void) {
 }
 
 void handle_start_screen_input(void) {
-    if (key(KEY_1)) {
-        demo_notify_start_screen_input();
-        selected_pit_size = 0; // 4x4
-        apply_selected_pit_size();
-        update_static_buffer();
-        draw_start_screen(STATIC_BUFFER_ADDR);
-        start_screen_drawn = true;
-    }
-    if (key(KEY_2)) {
-        demo_notify_start_screen_input();
-        selected_pit_size = 1; // 5x5
-        apply_selected_pit_size();
-        update_static_buffer();
-        draw_start_screen(STATIC_BUFFER_ADDR);
-        start_screen_drawn = true;
+    // Number keys pick a preset, arrows and -/= set width, depth, height
+    for (uint8_t i = 0; i < NUM_PIT_PRESETS; i++) {
+        if (action(ACT_PIT_1 + i)) {
+            demo_notify_start_screen_input();
+            select_pit_preset(i);
+        }
     }
-    if (key(KEY_SPACE)) {
+    if (action(ACT_LEFT))  adjust_pit_dimension(&PIT_WIDTH, -1, MIN_PIT_WIDTH, MAX_PIT_WIDTH);
+    if (action(ACT_RIGHT)) adjust_pit_dimension(&PIT_WIDTH, 1, MIN_PIT_WIDTH, MAX_PIT_WIDTH);
+    if (action(ACT_DOWN))  adjust_pit_dimension(&PIT_DEPTH, -1, MIN_PIT_DEPTH, MAX_PIT_DEPTH);
+    if (action(ACT_UP))    adjust_pit_dimension(&PIT_DEPTH, 1, MIN_PIT_DEPTH, MAX_PIT_DEPTH);
+    if (action(ACT_LOWER)) adjust_pit_dimension(&PIT_HEIGHT, -1, MIN_PIT_HEIGHT, MAX_PIT_HEIGHT);
+    if (action(ACT_RAISE)) adjust_pit_dimension(&PIT_HEIGHT, 1, MIN_PIT_HEIGHT, MAX_PIT_HEIGHT);
+    if (action(ACT_DROP)) {
         demo_notify_start_screen_input();
         apply_selected_pit_size();
         reset_game_state();
@@ -349,10 +477,27 @@ void handle_start_screen_input(void) {
     }
 }
 
-void read_keyboard(void) {
+void init_keyboard(void) {
     xregn(0, 0, 0, 1, KEYBOARD_INPUT);
-    for (uint8_t i = 0; i < KEYBOARD_BYTES; i++) {
-        RIA.addr0 = KEYBOARD_INPUT + i;
+}
+
+// One auto-incrementing stream over the bytes that hold bound keys. With
+// nothing pressed only the first byte is read.
+void read_keyboard(void) {
+    RIA.addr0 = KEYBOARD_INPUT;
+    RIA.step0 = 1;
+    uint8_t first = RIA.rw0;
+
+    if (first & 1) {
+        if (!(keystates[0] & 1)) {
+            for (uint8_t i = 1; i < KEYBOARD_SCAN_BYTES; i++) keystates[i] = 0;
+        }
+        keystates[0] = first;
+        return;
+    }
+
+    keystates[0] = first;
+    for (uint8_t i = 1; i < KEYBOARD_SCAN_BYTES; i++) {
         keystates[i] = RIA.rw0;
     }
 }
@@ -364,8 +509,15 @@ static bool any_key_pressed(void) {
 /* ================= MAIN ================= */
 
 int main(void) {
-    precompute_tables();
-    precompute_grid_coordinates();
+    load_rle_xram("ROM:background", STATIC_BUFFER_ADDR, STATIC_SIZE);
+#ifdef BLOCKOUT_MATH_BENCH
+    {
+        uint8_t slow, fast;
+        uint16_t bad = bench_perspective(&slow, &fast);
+        printf("perspective: %u mismatches, %u vs %u vsyncs\n", bad, slow, fast);
+    }
+#endif
+    select_grid_tables();
 
     init_graphics_plane(STATIC_STRUCT_ADDR, STATIC_BUFFER_ADDR,
         0, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 4);
@@ -379,9 +531,9 @@ int main(void) {
 
     update_static_buffer();
     init_sound();
+    init_keyboard();
 
     uint8_t v = RIA.vsync;
-    bool handled_key = false;
     int8_t last_shape_x = shape_pos_x;
     int8_t last_shape_y = shape_pos_y;
     int8_t last_shape_z = shape_pos_z;
@@ -393,10 +545,91 @@ int main(void) {
     GameState last_state_transition = state.current;
     
     while (true) {
-        // Wait for vsync
-        if (v == RIA.vsync) continue;
+        // Wait for vsync, spending the idle time on the demo search
+        if (v == RIA.vsync) {
+            demo_search_step();
+            continue;
+        }
         v = RIA.vsync;
         seed++;
+        profile_frame_begin(v);
+
+        // Input first, so this frame's simulation and render already see it
+        read_keyboard();
+        if (input_update() && action_events) {
+            profile_key_down();
+        }
+
+        bool demo_was_stopped = false;
+        if (demo_is_active() && any_key_pressed()) {
+            demo_stop();
+            start_screen_drawn = false;
+            demo_was_stopped = true;
+        }
+
+        if (demo_idle_update((state.current == STATE_START_SCREEN || state.current == STATE_GAME_OVER), any_key_pressed())) {
+            start_screen_drawn = false;
+        }
+
+        if (action_events && !demo_was_stopped) {
+            // Global keys
+            if (action(ACT_PAUSE)) {
+                uint16_t front_buffer = viewport_buffers[active_buffer];
+                if (state.current == STATE_PAUSED) {
+                    hide_pause_screen(front_buffer);
+                } else if (state.current != STATE_GAME_OVER) {
+                    draw_pause_screen(front_buffer);
+                }
+                toggle_pause();
+                // The front buffer is already correct, skip the re-render
+                last_state = state.current;
+            }
+            if (action(ACT_QUIT)) break;
+            
+            // State-specific input
+            switch(state.current) {
+                case STATE_START_SCREEN:
+                    handle_start_screen_input();
+                    break;
+
+                case STATE_PLAYING:
+                    handle_playing_input();
+                    break;
+                    
+                case STATE_LOCKING:
+                    handle_locking_input();
+                    break;
+                    
+                case STATE_GAME_OVER:
+                    handle_game_over_input();
+                    break;
+                    
+                default:
+                    break;
+            }
+            
+            // View and debug keys (work in any state except game over)
+            if (state.current != STATE_GAME_OVER) {
+                if (state.current != STATE_PAUSED) {
+                    if (action(ACT_VIEW)) toggle_view();
+                    // zoom_lut runs from the flattest view to the deepest
+                    if (action(ACT_ZOOM_IN)) change_zoom(-1);
+                    if (action(ACT_ZOOM_OUT)) change_zoom(1);
+                }
+                if (action(ACT_DEBUG_SHAPE)) {
+                    current_shape_idx = (current_shape_idx + 1) % NUM_SHAPES;
+                }
+                if (action(ACT_DEBUG_MODE)) {
+                    mode = (mode + 1) % NUM_MODES;
+                }
+                if (action(ACT_DEBUG_SHADOW)) {
+                    shadow_enabled = !shadow_enabled;
+                }
+                if (action(ACT_DEBUG_PROFILE)) {
+                    profile_toggle();
+                }
+            }
+        }
 
         // Update static buffer if needed
         if (state.need_static_redraw) {
@@ -404,6 +637,14 @@ int main(void) {
             state.need_static_redraw = false;
         }
 
+        // A resize or zoom redraws the static buffer over several frames
+        if (rebuild_stage != REBUILD_IDLE) {
+            pit_rebuild_step();
+        }
+
+        // Halve the static fills after an overrun; refine them with slack
+        quality_update(frame_time, rebuild_stage != REBUILD_IDLE || state.current != STATE_PLAYING);
+
         update_screen_shake();
 
         demo_tick();
@@ -425,6 +666,10 @@ int main(void) {
             case STATE_FAST_DROP:
                 handle_fast_drop_state();
                 break;
+
+            case STATE_HARD_DROP:
+                handle_hard_drop_state();
+                break;
                 
             case STATE_LOCKING:
                 handle_locking_state();
@@ -454,6 +699,7 @@ int main(void) {
         bool state_changed = (state.current != last_state);
         bool needs_render = (state.current != STATE_PAUSED) &&
                     (state.current != STATE_START_SCREEN) &&
+                    (state.current != STATE_HARD_DROP) &&
                             (shape_changed || state_changed || state.current == STATE_ANIMATING);
 
         if (needs_render) {
@@ -462,6 +708,7 @@ int main(void) {
             drawShape(back_buffer);
             switch_buffer_plane(VIEWPORT_STRUCT_ADDR, back_buffer);
             active_buffer = !active_buffer;
+            profile_flip();
 
             last_shape_x = shape_pos_x;
             last_shape_y = shape_pos_y;
@@ -471,68 +718,11 @@ int main(void) {
             last_angle_z = angleZ;
             last_shape_idx = current_shape_idx;
             last_state = state.current;
-        }
-
-        read_keyboard();
-
-        bool demo_was_stopped = false;
-        if (demo_is_active() && any_key_pressed()) {
-            demo_stop();
-            start_screen_drawn = false;
-            demo_was_stopped = true;
-        }
-
-        if (demo_idle_update((state.current == STATE_START_SCREEN || state.current == STATE_GAME_OVER), any_key_pressed())) {
-            start_screen_drawn = false;
-        }
-
-        if (!(keystates[0] & 1) && !demo_was_stopped) {
-            if (!handled_key) {
-                // Global keys
-                if (key(KEY_P)) {
-                    draw_pause_screen(viewport_buffers[active_buffer]);
-                    toggle_pause();
-                }
-                if (key(KEY_ESC)) break;
-                
-                // State-specific input
-                switch(state.current) {
-                    case STATE_START_SCREEN:
-                        handle_start_screen_input();
-                        break;
-
-                    case STATE_PLAYING:
-                        handle_playing_input();
-                        break;
-                        
-                    case STATE_LOCKING:
-                        handle_locking_input();
-                        break;
-                        
-                    case STATE_GAME_OVER:
-                        handle_game_over_input();
-                        break;
-                        
-                    default:
-                        break;
-                }
-                
-                // Debug keys (work in any state except game over)
-                if (state.current != STATE_GAME_OVER) {
-                    if (key(KEY_Z)) {
-                        current_shape_idx = (current_shape_idx + 1) % NUM_SHAPES;
-                    }
-                    if (key(KEY_M)) {
-                        mode = (mode + 1) % NUM_MODES;
-                    }
-                }
-                
-                handled_key = true;
-            }
         } else {
-            handled_key = false;
+            profile_no_flip();
         }
 
+        draw_profile_overlay(STATIC_BUFFER_ADDR);
         update_sound();
     }
     
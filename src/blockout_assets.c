@@ -0,0 +1,75 @@
+#include <rp6502.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "blockout_assets.h"
+
+#define RLE_CHUNK 128
+
+static uint8_t rle_buf[RLE_CHUNK];
+static uint8_t rle_pos;
+static uint8_t rle_len;
+static int rle_fd;
+
+static bool rle_fill(void) {
+    int n = read(rle_fd, rle_buf, RLE_CHUNK);
+    if (n <= 0) return false;
+    rle_len = (uint8_t)n;
+    rle_pos = 0;
+    return true;
+}
+
+static int16_t rle_getc(void) {
+    if (rle_pos == rle_len && !rle_fill()) return -1;
+    return rle_buf[rle_pos++];
+}
+
+// The file is read in small chunks and every output byte goes straight
+// to XRAM through the auto-incrementing rw0 port.
+bool load_rle_xram(const char *name, uint16_t addr, uint16_t size) {
+    rle_fd = open(name, O_RDONLY);
+    if (rle_fd < 0) {
+        printf("ERROR: reading %s %i\n\n", name, rle_fd);
+        return false;
+    }
+    rle_pos = rle_len = 0;
+
+    RIA.addr0 = addr;
+    RIA.step0 = 1;
+
+    while (size) {
+        int16_t c = rle_getc();
+        if (c < 0) break;
+
+        if (c < 0x80) {
+            // Literal packet, copied straight out of the read buffer
+            uint8_t count = (uint8_t)c + 1;
+            if (count > size) count = (uint8_t)size;
+            while (count) {
+                if (rle_pos == rle_len && !rle_fill()) goto done;
+                uint8_t avail = rle_len - rle_pos;
+                if (avail > count) avail = count;
+                count -= avail;
+                size -= avail;
+                while (avail--) RIA.rw0 = rle_buf[rle_pos++];
+            }
+        } else {
+            int16_t v = rle_getc();
+            if (v < 0) break;
+            uint8_t count = (uint8_t)c - 0x80 + 3;
+            if (count > size) count = (uint8_t)size;
+            size -= count;
+            while (count--) RIA.rw0 = (uint8_t)v;
+        }
+    }
+
+done:
+    close(rle_fd);
+    if (size) {
+        printf("ERROR: %s ended %u bytes early\n\n", name, size);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,11 @@
+#ifndef BLOCKOUT_ASSETS_H
+#define BLOCKOUT_ASSETS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Unpack a run-length packed image (tools/rle_pack.py) from the ROM
+// filesystem into XRAM at addr. Stops after size bytes.
+bool load_rle_xram(const char *name, uint16_t addr, uint16_t size);
+
+#endif
@@ -9,6 +9,7 @@
 #include "blockout_pit.h"
 #include "blockout_state.h"
 #include "bitmap_graphics_db.h"
+#include "blockout_random.h"
 
 static const uint16_t DEMO_START_DELAY_FRAMES = 600;
 
@@ -18,15 +19,209 @@ static uint16_t demo_timer = 0;
 static uint16_t demo_lines_base = 0;
 static uint16_t demo_last_cubes_played = 0;
 static uint8_t demo_clear_target = 0;
+static uint8_t demo_step_wait = 1;     // Frames until the next movement step
 
-// Random movement plan for current shape
-static int8_t demo_move_dir_x = 0;   // -1 = left, 1 = right, 0 = no move
-static int8_t demo_move_dir_y = 0;   // -1 = front, 1 = back, 0 = no move
-static uint8_t demo_steps_x = 0;     // Steps remaining in X
-static uint8_t demo_steps_y = 0;     // Steps remaining in Y
+// Movement plan for current shape, taken from the search result
+static int8_t demo_target_x = 0;
+static int8_t demo_target_y = 0;
+static uint8_t demo_target_orient = 0;
+static bool demo_rotation_done = false;
+static bool demo_plan_committed = false;
 static bool demo_movement_done = false;
 static bool demo_center_drop_active = false;
 
+// Frames the demo waits for the search before committing to the best plan so far
+#define DEMO_THINK_FRAMES 45
+
+/* ================= SEARCH ================= */
+
+#define DEMO_W_DEPTH 4
+#define DEMO_W_HOLE  24
+#define DEMO_W_CLEAR 96
+
+// Placement search state. Each call to demo_search_step() scores one
+// candidate (rotation, x, y), so the enumeration survives across frames
+// and only ever runs in the idle time while waiting for vsync.
+static struct {
+    bool active;
+    uint8_t shape;
+    uint8_t orient;
+    int8_t x, y;
+    int8_t min_x, max_x, min_y, max_y;
+    int8_t rx[MAX_BLOCKS], ry[MAX_BLOCKS], rz[MAX_BLOCKS];
+    bool has_best;
+    int16_t best_score;
+    uint8_t best_orient;
+    int8_t best_x, best_y;
+} search;
+
+// Cache the rotated offsets and the position range that keeps the
+// footprint inside the pit for the current rotation candidate.
+static void demo_search_load_rotation(void) {
+    const Shape *s = &shapes[current_shape_idx];
+    int8_t lo_x = 0, hi_x = 0, lo_y = 0, hi_y = 0;
+
+    for (uint8_t b = 0; b < s->num_blocks; b++) {
+        get_rotated_offset(b, search.orient, &search.rx[b], &search.ry[b], &search.rz[b]);
+        if (search.rx[b] < lo_x) lo_x = search.rx[b];
+        if (search.rx[b] > hi_x) hi_x = search.rx[b];
+        if (search.ry[b] < lo_y) lo_y = search.ry[b];
+        if (search.ry[b] > hi_y) hi_y = search.ry[b];
+    }
+    search.min_x = -lo_x;
+    search.max_x = (int8_t)(PIT_WIDTH - 1) - hi_x;
+    search.min_y = -lo_y;
+    search.max_y = (int8_t)(PIT_DEPTH - 1) - hi_y;
+    search.x = search.min_x;
+    search.y = search.min_y;
+}
+
+static bool demo_search_fits(int8_t px, int8_t py, int8_t pz) {
+    const Shape *s = &shapes[current_shape_idx];
+    for (uint8_t b = 0; b < s->num_blocks; b++) {
+        int8_t z = pz + search.rz[b];
+        if (z < 0 || z >= PIT_HEIGHT) return false;
+        if (pit_cell(px + search.rx[b], py + search.ry[b], z)) return false;
+    }
+    return true;
+}
+
+// Same heightmap drop as landing_z(), on the cached offsets
+static int8_t demo_search_landing(int8_t px, int8_t py, int8_t pz) {
+    const Shape *s = &shapes[current_shape_idx];
+    int8_t land = PIT_HEIGHT;
+    for (uint8_t b = 0; b < s->num_blocks; b++) {
+        uint8_t top = column_top[py + search.ry[b]][px + search.rx[b]];
+        if (pz + search.rz[b] >= (int8_t)top) {
+            while (demo_search_fits(px, py, pz + 1)) pz++;
+            return pz;
+        }
+        int8_t limit = (int8_t)top - 1 - search.rz[b];
+        if (limit < land) land = limit;
+    }
+    return land;
+}
+
+static bool demo_search_in_piece(int8_t x, int8_t y, int8_t z, int8_t px, int8_t py, int8_t pz) {
+    const Shape *s = &shapes[current_shape_idx];
+    for (uint8_t b = 0; b < s->num_blocks; b++) {
+        if (px + search.rx[b] == x && py + search.ry[b] == y && pz + search.rz[b] == z) return true;
+    }
+    return false;
+}
+
+// Deeper placements are better, holes left under the piece are bad and
+// completed layers are best.
+static int16_t demo_search_score(int8_t px, int8_t py, int8_t pz) {
+    const Shape *s = &shapes[current_shape_idx];
+    int16_t score = 0;
+
+    for (uint8_t b = 0; b < s->num_blocks; b++) {
+        int8_t x = px + search.rx[b];
+        int8_t y = py + search.ry[b];
+        int8_t z = pz + search.rz[b];
+        bool layer_seen = false;
+
+        score += z * DEMO_W_DEPTH;
+
+        if (z + 1 < PIT_HEIGHT && !pit_cell(x, y, z + 1) && !demo_search_in_piece(x, y, z + 1, px, py, pz)) {
+            score -= DEMO_W_HOLE;
+        }
+
+        for (uint8_t o = 0; o < b; o++) {
+            if (pz + search.rz[o] == z) { layer_seen = true; break; }
+        }
+        if (!layer_seen) {
+            uint8_t filled = 0;
+            for (uint8_t o = 0; o < s->num_blocks; o++) {
+                if (pz + search.rz[o] == z) filled++;
+            }
+            for (uint8_t yy = 0; yy < PIT_DEPTH; yy++) {
+                uint8_t row = pit_rows[z][yy];
+                for (; row; row &= row - 1) filled++;
+            }
+            if (filled == PIT_WIDTH * PIT_DEPTH) score += DEMO_W_CLEAR;
+        }
+    }
+    return score;
+}
+
+static void demo_search_begin(void) {
+    search.active = true;
+    search.shape = current_shape_idx;
+    search.has_best = false;
+    search.orient = 0;
+    demo_search_load_rotation();
+}
+
+static void demo_search_advance(void) {
+    if (++search.x <= search.max_x) return;
+    search.x = search.min_x;
+    if (++search.y <= search.max_y) return;
+
+    if (++search.orient >= NUM_ORIENTS) {
+        search.active = false;
+        return;
+    }
+    demo_search_load_rotation();
+}
+
+bool demo_search_step(void) {
+    if (!demo_mode || !search.active) return false;
+    if (search.shape != current_shape_idx) {
+        // Piece locked before the plan was taken; demo_tick restarts the search
+        search.active = false;
+        return false;
+    }
+
+    int8_t px = search.x;
+    int8_t py = search.y;
+
+    if (search.min_x <= search.max_x && search.min_y <= search.max_y) {
+        // Same entry rule as a wall kick at spawn: allow a push of up to two layers
+        int8_t pz = -1;
+        for (int8_t z = 0; z < 3; z++) {
+            if (demo_search_fits(px, py, z)) { pz = z; break; }
+        }
+        if (pz >= 0) {
+            pz = demo_search_landing(px, py, pz);
+            int16_t score = demo_search_score(px, py, pz);
+            if (!search.has_best || score > search.best_score) {
+                search.has_best = true;
+                search.best_score = score;
+                search.best_orient = search.orient;
+                search.best_x = px;
+                search.best_y = py;
+            }
+        }
+    } else {
+        // Rotation cannot fit this pit at all
+        search.x = search.max_x;
+        search.y = search.max_y;
+    }
+
+    demo_search_advance();
+    return true;
+}
+
+// Take the best plan found so far. Falls back to dropping in place.
+static void demo_commit_plan(void) {
+    search.active = false;
+    demo_plan_committed = true;
+    if (search.has_best) {
+        demo_target_orient = search.best_orient;
+        demo_target_x = search.best_x;
+        demo_target_y = search.best_y;
+    } else {
+        demo_target_orient = 0;
+        demo_target_x = shape_pos_x;
+        demo_target_y = shape_pos_y;
+    }
+    demo_rotation_done = (demo_target_orient == 0);
+    demo_movement_done = false;
+    demo_step_wait = 1;
+}
+
 extern void apply_selected_pit_size(void);
 extern void reset_game_state(void);
 extern void update_static_buffer(void);
@@ -48,100 +243,44 @@ static void demo_fill_bottom_level(void) {
         for (uint8_t x = 0; x < PIT_WIDTH; x++) {
             // Skip the center position
             if (x == center_x && y == center_y) {
-                pit[bottom_z][y][x] = 0;
+                pit_reset(x, y, bottom_z);
             } else {
-                pit[bottom_z][y][x] = 1;
-                pit_colors[bottom_z][y][x] = layer_colors[bottom_z];
+                pit_set(x, y, bottom_z);
             }
         }
     }
+    rebuild_column_tops();
 }
 
 
 
-static void demo_plan_random_movement(void) {
-    // Select random direction and steps for X axis
-    demo_move_dir_x = (int8_t)(random(0, 2) ? 1 : -1);  // 1 = right, -1 = left
-    demo_steps_x = (uint8_t)random(0, PIT_WIDTH / 2 + 1);  // 0 to 5 steps
-    
-    // Select random direction and steps for Y axis
-    demo_move_dir_y = (int8_t)(random(0, 2) ? 1 : -1);  // 1 = back, -1 = front
-    demo_steps_y = (uint8_t)random(0, PIT_DEPTH / 2 + 1);  // 0 to 5 steps
-    
-    demo_movement_done = false;
-}
-
 static void demo_execute_movement_step(void) {
     if (state.current == STATE_ANIMATING) return;
-    
-    bool moved = false;
-    
-    // Try to move in X direction if steps remain
-    if (demo_steps_x > 0) {
-        int8_t new_x = shape_pos_x + demo_move_dir_x;
+
+    // Rotate first, at the spawn position, so kicks have room
+    if (!demo_rotation_done) {
+        const uint8_t *a = orient_angles[demo_target_orient];
+        demo_rotation_done = true;
+        begin_rotation(demo_target_orient, a[0], a[1], a[2]);
+        return;
+    }
+
+    // One cell per step, X before Y. A blocked move ends the plan early.
+    if (shape_pos_x != demo_target_x) {
+        int8_t new_x = shape_pos_x + ((demo_target_x > shape_pos_x) ? 1 : -1);
         if (is_position_valid(new_x, shape_pos_y, shape_pos_z)) {
             shape_pos_x = new_x;
-            moved = true;
+            return;
         }
-        demo_steps_x--;
-    }
-    
-    // Try to move in Y direction if steps remain
-    if (!moved && demo_steps_y > 0) {
-        int8_t new_y = shape_pos_y + demo_move_dir_y;
+    } else if (shape_pos_y != demo_target_y) {
+        int8_t new_y = shape_pos_y + ((demo_target_y > shape_pos_y) ? 1 : -1);
         if (is_position_valid(shape_pos_x, new_y, shape_pos_z)) {
             shape_pos_y = new_y;
-            moved = true;
-        }
-        demo_steps_y--;
-    }
-    
-    // After each movement, randomly decide if we should rotate
-    if (random(0, 2)) {  // 50% chance to rotate
-        uint8_t axis = (uint8_t)random(0, 3);  // 0=X, 1=Y, 2=Z
-        uint8_t step = ANGLE_STEP_90;
-        int8_t kX, kY, kZ;
-        
-        if (axis == 0) {
-            // Rotate on X axis
-            uint8_t nextX = (uint8_t)(targetX + step);
-            if (try_wall_kick(nextX, targetY, targetZ, &kX, &kY, &kZ)) {
-                shape_pos_x = kX;
-                shape_pos_y = kY;
-                shape_pos_z = kZ;
-                targetX = nextX;
-                change_state(STATE_ANIMATING);
-                return;
-            }
-        } else if (axis == 1) {
-            // Rotate on Y axis
-            uint8_t nextY = (uint8_t)(targetY + step);
-            if (try_wall_kick(targetX, nextY, targetZ, &kX, &kY, &kZ)) {
-                shape_pos_x = kX;
-                shape_pos_y = kY;
-                shape_pos_z = kZ;
-                targetY = nextY;
-                change_state(STATE_ANIMATING);
-                return;
-            }
-        } else {
-            // Rotate on Z axis
-            uint8_t nextZ = (uint8_t)(targetZ + step);
-            if (try_wall_kick(targetX, targetY, nextZ, &kX, &kY, &kZ)) {
-                shape_pos_x = kX;
-                shape_pos_y = kY;
-                shape_pos_z = kZ;
-                targetZ = nextZ;
-                change_state(STATE_ANIMATING);
-                return;
-            }
+            return;
         }
     }
-    
-    // Check if movement is complete
-    if (demo_steps_x == 0 && demo_steps_y == 0) {
-        demo_movement_done = true;
-    }
+
+    demo_movement_done = true;
 }
 
 static void demo_reset_cycle(void) {
@@ -149,7 +288,7 @@ static void demo_reset_cycle(void) {
     demo_fill_bottom_level();
     update_static_buffer();
 
-    demo_clear_target = 1 + (uint8_t)random(0, 2);
+    demo_clear_target = 1 + rng_range(2);
     demo_lines_base = lines_cleared;
     demo_timer = 0;
     demo_center_drop_active = true;
@@ -157,22 +296,23 @@ static void demo_reset_cycle(void) {
     next_shape_idx = 0;
     spawn_new_shape();
     demo_last_cubes_played = cubes_played;
+    demo_plan_committed = false;
     demo_movement_done = false;
+    search.active = false;
 }
 
 static void demo_on_new_shape(void) {
     if (demo_center_drop_active) {
         demo_center_drop_active = false;
         demo_lines_base = lines_cleared;
-        demo_plan_random_movement();
-        return;
-    }
-
-    if (lines_cleared >= (uint16_t)(demo_lines_base + demo_clear_target)) {
+    } else if (lines_cleared >= (uint16_t)(demo_lines_base + demo_clear_target)) {
         demo_reset_cycle();
         return;
     }
-    demo_plan_random_movement();
+    demo_timer = 0;
+    demo_plan_committed = false;
+    demo_movement_done = false;
+    demo_search_begin();
 }
 
 bool demo_is_active(void) {
@@ -204,8 +344,16 @@ void demo_tick(void) {
         return;
     }
     
+    // Commit once the search is exhausted or the piece has waited long enough
+    if (!demo_plan_committed) {
+        if (search.active && demo_timer < DEMO_THINK_FRAMES) return;
+        demo_commit_plan();
+        demo_timer = 0;
+    }
+
     // Execute movement steps periodically
-    if ((demo_timer % random(8, 50)) == 0) {
+    if (--demo_step_wait == 0) {
+        demo_step_wait = 8 + rng_range(42);
         if (!demo_movement_done) {
             demo_execute_movement_step();
         }
@@ -5,6 +5,7 @@
 
 bool demo_is_active(void);
 void demo_tick(void);
+bool demo_search_step(void);
 void demo_start(void);
 void demo_stop(void);
 bool demo_idle_update(bool is_start_screen, bool key_pressed);
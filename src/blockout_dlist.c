@@ -0,0 +1,390 @@
+#include <rp6502.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "colors.h"
+#include "blockout_types.h"
+#include "blockout_dlist.h"
+
+#define DL_ROW_BYTES 128        // Primitives reach x = 255
+#define DL_VIEW_LO   (VIEWPORT_X >> 1)
+#define DL_VIEW_HI   ((VIEWPORT_X + VIEWPORT_WIDTH - 1) >> 1)
+
+enum {
+    DL_RECT,
+    DL_FRAME,
+    DL_LINE,
+    DL_QUAD
+};
+
+// Primitive pool, in painter's order. x and y hold the corners of a
+// rectangle or frame, the ends of a line or the points of a quad.
+static uint8_t prim_kind[DL_MAX_PRIMS];
+static uint8_t prim_color[DL_MAX_PRIMS];
+static uint8_t prim_stride[DL_MAX_PRIMS];
+static uint8_t prim_row0[DL_MAX_PRIMS];   // First row drawn
+static uint8_t prim_ymax[DL_MAX_PRIMS];   // Last row reached
+static uint8_t prim_x[DL_MAX_PRIMS][4];
+static uint8_t prim_y[DL_MAX_PRIMS][4];
+static uint8_t prim_count = 0;
+
+static uint8_t dirty_min_y = SCREEN_HEIGHT;
+static uint8_t dirty_max_y = 0;
+static bool clear_pending = false;
+
+// The band being composed. The mask holds the nibbles painted so far.
+static uint8_t band_buf[DL_BAND_ROWS][DL_ROW_BYTES];
+static uint8_t band_mask[DL_BAND_ROWS][DL_ROW_BYTES];
+static uint8_t band_lo[DL_BAND_ROWS];
+static uint8_t band_hi[DL_BAND_ROWS];
+static uint8_t band_y0, band_y1;
+
+static uint8_t quad_left[DL_BAND_ROWS];
+static uint8_t quad_right[DL_BAND_ROWS];
+
+static inline uint8_t clamp_x(int16_t x) {
+    if (x < 0) return 0;
+    if (x > 255) return 255;
+    return (uint8_t)x;
+}
+
+static inline uint8_t clamp_y(int16_t y) {
+    if (y < 0) return 0;
+    if (y > SCREEN_HEIGHT - 1) return SCREEN_HEIGHT - 1;
+    return (uint8_t)y;
+}
+
+// First row at or below y with the parity phase when stride is 2
+static inline uint8_t first_row(uint8_t y, uint8_t stride, uint8_t phase) {
+    return y + ((phase - y) & (stride - 1));
+}
+
+static uint8_t new_prim(uint8_t kind, uint8_t color, uint8_t stride, uint8_t row0, uint8_t ymax) {
+    if (prim_count == DL_MAX_PRIMS) dl_flush();
+
+    uint8_t i = prim_count++;
+    prim_kind[i] = kind;
+    prim_color[i] = color;
+    prim_stride[i] = stride;
+    prim_row0[i] = row0;
+    prim_ymax[i] = ymax;
+
+    if (row0 < dirty_min_y) dirty_min_y = row0;
+    if (ymax > dirty_max_y) dirty_max_y = ymax;
+    return i;
+}
+
+static void box_prim(uint8_t kind, uint8_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                     uint8_t stride, uint8_t phase) {
+    uint8_t cy0 = clamp_y(y0), cy1 = clamp_y(y1);
+    uint8_t row0 = first_row(cy0, stride, phase);
+    if (row0 > cy1) return;
+
+    uint8_t i = new_prim(kind, color, stride, row0, cy1);
+    prim_x[i][0] = clamp_x(x0);
+    prim_x[i][1] = clamp_x(x1);
+    prim_y[i][0] = cy0;
+    prim_y[i][1] = cy1;
+}
+
+void dl_rect(uint8_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+             uint8_t stride, uint8_t phase) {
+    box_prim(DL_RECT, color, x0, y0, x1, y1, stride, phase);
+}
+
+void dl_frame(uint8_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+              uint8_t stride, uint8_t phase) {
+    box_prim(DL_FRAME, color, x0, y0, x1, y1, stride, phase);
+}
+
+void dl_line(uint8_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    uint8_t cx0 = clamp_x(x0), cx1 = clamp_x(x1);
+    uint8_t cy0 = clamp_y(y0), cy1 = clamp_y(y1);
+
+    // Upright lines are one rectangle rather than a span per row
+    if (cx0 == cx1 || cy0 == cy1) {
+        box_prim(DL_RECT, color,
+                 cx0 < cx1 ? cx0 : cx1, cy0 < cy1 ? cy0 : cy1,
+                 cx0 < cx1 ? cx1 : cx0, cy0 < cy1 ? cy1 : cy0, 1, 0);
+        return;
+    }
+
+    uint8_t i = new_prim(DL_LINE, color, 1, cy0 < cy1 ? cy0 : cy1, cy0 < cy1 ? cy1 : cy0);
+    prim_x[i][0] = cx0;
+    prim_y[i][0] = cy0;
+    prim_x[i][1] = cx1;
+    prim_y[i][1] = cy1;
+}
+
+void dl_quad(uint8_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+             int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+             uint8_t stride, uint8_t phase) {
+    uint8_t px[4], py[4];
+    uint8_t min_y = SCREEN_HEIGHT, max_y = 0;
+    px[0] = clamp_x(x0); py[0] = clamp_y(y0);
+    px[1] = clamp_x(x1); py[1] = clamp_y(y1);
+    px[2] = clamp_x(x2); py[2] = clamp_y(y2);
+    px[3] = clamp_x(x3); py[3] = clamp_y(y3);
+
+    for (uint8_t k = 0; k < 4; k++) {
+        if (py[k] < min_y) min_y = py[k];
+        if (py[k] > max_y) max_y = py[k];
+    }
+    uint8_t row0 = first_row(min_y, stride, phase);
+    if (row0 > max_y) return;
+
+    uint8_t i = new_prim(DL_QUAD, color, stride, row0, max_y);
+    for (uint8_t k = 0; k < 4; k++) {
+        prim_x[i][k] = px[k];
+        prim_y[i][k] = py[k];
+    }
+}
+
+void dl_clear_viewport(void) {
+    clear_pending = true;
+}
+
+/* ================= COMPOSE ================= */
+
+static void paint_span(uint8_t r, uint8_t x0, uint8_t x1, uint8_t color) {
+    uint8_t *p = &band_buf[r][x0 >> 1];
+    uint8_t *m = &band_mask[r][x0 >> 1];
+    uint8_t color_hi = (uint8_t)(color << 4);
+
+    if ((x0 >> 1) < band_lo[r]) band_lo[r] = x0 >> 1;
+    if ((x1 >> 1) > band_hi[r]) band_hi[r] = x1 >> 1;
+
+    if (x0 & 1) {
+        *p = (*p & 0xF0) | color;
+        *m |= 0x0F;
+        if (x0 == x1) return;
+        p++; m++;
+        x0++;
+    }
+    uint8_t n = (uint8_t)(((uint16_t)x1 - x0 + 1) >> 1);
+    uint8_t both = color_hi | color;
+    while (n--) {
+        *p++ = both;
+        *m++ = 0xFF;
+    }
+    if (!(x1 & 1)) {
+        *p = (*p & 0x0F) | color_hi;
+        *m |= 0xF0;
+    }
+}
+
+// First row of the band drawn by a primitive starting at row0
+static inline uint8_t band_first(uint8_t row0, uint8_t stride) {
+    if (row0 >= band_y0) return row0;
+    return band_y0 + ((row0 - band_y0) & (stride - 1));
+}
+
+static inline uint8_t band_last(uint8_t ymax) {
+    return (ymax < band_y1) ? ymax : band_y1;
+}
+
+static void compose_box(uint8_t i) {
+    uint8_t stride = prim_stride[i];
+    uint8_t last = band_last(prim_ymax[i]);
+    uint8_t x0 = prim_x[i][0], x1 = prim_x[i][1];
+    uint8_t color = prim_color[i];
+    bool frame = (prim_kind[i] == DL_FRAME);
+
+    for (uint8_t y = band_first(prim_row0[i], stride); y <= last; y += stride) {
+        uint8_t r = y - band_y0;
+        if (!frame || y == prim_y[i][0] || y == prim_y[i][1]) {
+            paint_span(r, x0, x1, color);
+        } else {
+            paint_span(r, x0, x0, color);
+            paint_span(r, x1, x1, color);
+        }
+    }
+}
+
+static inline void line_span(uint8_t y, uint8_t x0, uint8_t x1, uint8_t color) {
+    if (y >= band_y0 && y <= band_y1) paint_span(y - band_y0, x0, x1, color);
+}
+
+// Steps exactly as draw_line2plane() does, painting the runs that fall in
+// the band and stopping once the line has left it
+static void compose_line(uint8_t i) {
+    int16_t x0 = prim_x[i][0], y0 = prim_y[i][0];
+    int16_t x1 = prim_x[i][1], y1 = prim_y[i][1];
+    uint8_t color = prim_color[i];
+
+    int16_t dx = x1 - x0; if (dx < 0) dx = -dx;
+    int16_t dy = y1 - y0; if (dy < 0) dy = -dy;
+    int16_t sx = (x0 < x1) ? 1 : -1;
+    int16_t sy = (y0 < y1) ? 1 : -1;
+    int16_t past = (sy > 0) ? band_y1 + 1 : band_y0 - 1;
+
+    if (dx <= 2 && dy <= 2) {
+        int16_t steps = (dx > dy ? dx : dy) + 1;
+        for (int16_t k = 0; k < steps; k++) {
+            line_span(y0, x0, x0, color);
+            if (x0 == x1 && y0 == y1) break;
+            if (dx >= dy) x0 += sx;
+            if (dy >= dx) y0 += sy;
+        }
+        return;
+    }
+
+    if (dx >= dy) {
+        int16_t err = dx / 2;
+        int16_t run = x0;
+        for (int16_t k = 0; ; k++) {
+            err -= dy;
+            if (err < 0 || k == dx) {
+                if (run < x0) line_span(y0, run, x0, color);
+                else line_span(y0, x0, run, color);
+                if (k == dx) break;
+                y0 += sy;
+                if (y0 == past) break;
+                err += dx;
+                run = x0 + sx;
+            }
+            x0 += sx;
+        }
+    } else {
+        int16_t err = dy / 2;
+        for (int16_t k = 0; ; k++) {
+            line_span(y0, x0, x0, color);
+            err -= dx;
+            if (err < 0) {
+                x0 += sx;
+                err += dy;
+            }
+            if (k == dy) break;
+            y0 += sy;
+            if (y0 == past) break;
+        }
+    }
+}
+
+// Edges are walked as draw_poly_fast() walks them, keeping the rows of
+// the band
+static void compose_quad(uint8_t i) {
+    uint8_t last = band_last(prim_ymax[i]);
+    uint8_t r;
+
+    for (r = 0; r < DL_BAND_ROWS; r++) {
+        quad_left[r] = 255;
+        quad_right[r] = 0;
+    }
+
+    for (uint8_t k = 0; k < 4; k++) {
+        uint8_t x_s = prim_x[i][k], y_s = prim_y[i][k];
+        uint8_t x_e = prim_x[i][(k + 1) & 3], y_e = prim_y[i][(k + 1) & 3];
+        if (y_s == y_e) continue;
+        if (y_s > y_e) { uint8_t t; t = x_s; x_s = x_e; x_e = t; t = y_s; y_s = y_e; y_e = t; }
+        if (y_e < band_y0 || y_s > band_y1) continue;
+
+        uint16_t dx = (x_e >= x_s) ? (x_e - x_s) : (x_s - x_e);
+        uint16_t dy = y_e - y_s;
+        int16_t sx = (x_e >= x_s) ? 1 : -1;
+        int16_t err = dy >> 1;
+        int16_t cur_x = x_s;
+
+        for (uint8_t y = y_s; ; y++) {
+            if (y >= band_y0) {
+                r = y - band_y0;
+                if ((uint8_t)cur_x < quad_left[r]) quad_left[r] = (uint8_t)cur_x;
+                if ((uint8_t)cur_x > quad_right[r]) quad_right[r] = (uint8_t)cur_x;
+            }
+            if (y == y_e || y == band_y1) break;
+            err += dx;
+            while (err >= (int16_t)dy) { err -= dy; cur_x += sx; }
+        }
+    }
+
+    uint8_t stride = prim_stride[i];
+    for (uint8_t y = band_first(prim_row0[i], stride); y <= last; y += stride) {
+        r = y - band_y0;
+        if (quad_left[r] <= quad_right[r]) paint_span(r, quad_left[r], quad_right[r], prim_color[i]);
+    }
+}
+
+static void compose_band(void) {
+    uint8_t r, b;
+
+    for (r = 0; r < DL_BAND_ROWS; r++) {
+        band_lo[r] = 0xFF;
+        band_hi[r] = 0;
+        if (clear_pending && band_y0 + r <= band_y1) {
+            for (b = DL_VIEW_LO; b <= DL_VIEW_HI; b++) {
+                band_buf[r][b] = (BLACK << 4) | BLACK;
+                band_mask[r][b] = 0xFF;
+            }
+            band_lo[r] = DL_VIEW_LO;
+            band_hi[r] = DL_VIEW_HI;
+        }
+    }
+
+    for (uint8_t i = 0; i < prim_count; i++) {
+        if (prim_row0[i] > band_y1 || prim_ymax[i] < band_y0) continue;
+        switch (prim_kind[i]) {
+            case DL_RECT:
+            case DL_FRAME:
+                compose_box(i);
+                break;
+            case DL_LINE:
+                compose_line(i);
+                break;
+            case DL_QUAD:
+                compose_quad(i);
+                break;
+        }
+    }
+}
+
+// Port 0 streams the finished bytes; port 1 fetches the old value of a
+// byte whose nibbles were not both painted
+static void emit_band(void) {
+    RIA.step0 = 1;
+    RIA.step1 = 0;
+    for (uint8_t r = 0; band_y0 + r <= band_y1; r++) {
+        uint8_t lo = band_lo[r], hi = band_hi[r];
+        if (lo > hi) continue;
+
+        uint16_t base = STATIC_BUFFER_ADDR + (uint16_t)(band_y0 + r) * (SCREEN_WIDTH / 2);
+        bool streaming = false;
+        for (uint8_t b = lo; ; b++) {
+            uint8_t m = band_mask[r][b];
+            if (m) {
+                uint8_t v = band_buf[r][b];
+                if (m != 0xFF) {
+                    RIA.addr1 = base + b;
+                    v = (RIA.rw1 & (uint8_t)~m) | (v & m);
+                }
+                if (!streaming) RIA.addr0 = base + b;
+                RIA.rw0 = v;
+                band_mask[r][b] = 0;
+                streaming = true;
+            } else {
+                streaming = false;
+            }
+            if (b == hi) break;
+        }
+    }
+}
+
+void dl_flush(void) {
+    uint8_t y0 = dirty_min_y, y1 = dirty_max_y;
+
+    if (clear_pending) {
+        y0 = 0;
+        if (y1 < VIEWPORT_HEIGHT - 1) y1 = VIEWPORT_HEIGHT - 1;
+    }
+    if (y0 <= y1) {
+        for (band_y0 = y0; ; band_y0 += DL_BAND_ROWS) {
+            band_y1 = (y1 - band_y0 < DL_BAND_ROWS) ? y1 : band_y0 + DL_BAND_ROWS - 1;
+            compose_band();
+            emit_band();
+            if (band_y1 == y1) break;
+        }
+    }
+
+    prim_count = 0;
+    dirty_min_y = SCREEN_HEIGHT;
+    dirty_max_y = 0;
+    clear_pending = false;
+}
@@ -0,0 +1,47 @@
+#ifndef BLOCKOUT_DLIST_H
+#define BLOCKOUT_DLIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ================= DISPLAY LIST ================= */
+
+// Drawing on the static plane is queued here as primitives in painter's
+// order. A flush composes the screen a band of rows at a time in RAM,
+// replaying the primitives that reach the band, and streams each row out
+// with step0 = 1, so every touched byte is written once, in ascending
+// address order. Only bytes a primitive covers in part are read back.
+
+// Primitives held before a flush is forced; a layer of cubes fits
+#define DL_MAX_PRIMS 255
+
+// Rows composed per pass of the flush
+#define DL_BAND_ROWS 8
+
+// Coordinates are clamped to x 0..255 and the screen's rows, so a shape
+// running past the bottom collapses onto the last row as lines would.
+// Rectangles and quads with stride 2 fill only the rows of parity phase.
+
+// Filled rectangle x0..x1, y0..y1
+void dl_rect(uint8_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+             uint8_t stride, uint8_t phase);
+
+// Outline of the same rectangle, one pixel wide
+void dl_frame(uint8_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+              uint8_t stride, uint8_t phase);
+
+// Line with the same pixels draw_line2buffer() would set
+void dl_line(uint8_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+// Filled convex quad with the same rows draw_poly_fast() always drew
+void dl_quad(uint8_t color, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+             int16_t x2, int16_t y2, int16_t x3, int16_t y3,
+             uint8_t stride, uint8_t phase);
+
+// The next flush treats the viewport as black instead of reading it
+void dl_clear_viewport(void);
+
+// Put everything queued on the static plane
+void dl_flush(void);
+
+#endif
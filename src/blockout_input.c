@@ -1,4 +1,91 @@
 #include "blockout_input.h"
 
 uint8_t keystates[32];
-bool handled_key = false;
\ No newline at end of file
+
+static uint8_t keys_last[32];
+
+#define MOVE_DAS 12
+#define MOVE_ARR 4
+
+ActionBinding action_bindings[NUM_ACTIONS] = {
+    [ACT_LEFT]         = {KEY_LEFT,  KEY_NONE,    MOVE_DAS, MOVE_ARR},
+    [ACT_RIGHT]        = {KEY_RIGHT, KEY_NONE,    MOVE_DAS, MOVE_ARR},
+    [ACT_UP]           = {KEY_UP,    KEY_NONE,    MOVE_DAS, MOVE_ARR},
+    [ACT_DOWN]         = {KEY_DOWN,  KEY_NONE,    MOVE_DAS, MOVE_ARR},
+    [ACT_RAISE]        = {KEY_EQUAL, KEY_KPEQUAL, MOVE_DAS, MOVE_ARR},
+    [ACT_LOWER]        = {KEY_MINUS, KEY_NONE,    MOVE_DAS, MOVE_ARR},
+    [ACT_TURN_X_POS]   = {KEY_Q,     KEY_NONE,    0, 0},
+    [ACT_TURN_Y_POS]   = {KEY_W,     KEY_NONE,    0, 0},
+    [ACT_TURN_Z_POS]   = {KEY_E,     KEY_NONE,    0, 0},
+    [ACT_TURN_X_NEG]   = {KEY_A,     KEY_NONE,    0, 0},
+    [ACT_TURN_Y_NEG]   = {KEY_S,     KEY_NONE,    0, 0},
+    [ACT_TURN_Z_NEG]   = {KEY_D,     KEY_NONE,    0, 0},
+    [ACT_DROP]         = {KEY_SPACE, KEY_NONE,    0, 0},
+    [ACT_PAUSE]        = {KEY_P,     KEY_NONE,    0, 0},
+    [ACT_QUIT]         = {KEY_ESC,   KEY_NONE,    0, 0},
+    [ACT_RESTART]      = {KEY_R,     KEY_NONE,    0, 0},
+    [ACT_PIT_1]        = {KEY_1,     KEY_NONE,    0, 0},
+    [ACT_PIT_2]        = {KEY_2,     KEY_NONE,    0, 0},
+    [ACT_PIT_3]        = {KEY_3,     KEY_NONE,    0, 0},
+    [ACT_PIT_4]        = {KEY_4,     KEY_NONE,    0, 0},
+    [ACT_VIEW]         = {KEY_V,     KEY_NONE,    0, 0},
+    [ACT_ZOOM_IN]      = {KEY_RIGHTBRACE, KEY_NONE, 0, 0},
+    [ACT_ZOOM_OUT]     = {KEY_LEFTBRACE,  KEY_NONE, 0, 0},
+    [ACT_DEBUG_SHAPE]  = {KEY_Z,     KEY_NONE,    0, 0},
+    [ACT_DEBUG_MODE]   = {KEY_M,     KEY_NONE,    0, 0},
+    [ACT_DEBUG_SHADOW] = {KEY_G,     KEY_NONE,    0, 0},
+    [ACT_DEBUG_PROFILE]= {KEY_F,     KEY_NONE,    0, 0},
+};
+
+uint32_t action_events = 0;
+
+static uint32_t actions_held = 0;
+static uint8_t repeat_timer[NUM_ACTIONS];
+
+// KEY_NONE is bit 0 of the bitmap, which the RIA sets when nothing is down,
+// so an unused alternate must never be tested
+static inline bool binding_held(const ActionBinding *b) {
+    if (key(b->key)) return true;
+    return b->alt_key != KEY_NONE && key(b->alt_key);
+}
+
+bool input_update(void) {
+    bool any_down = !(keystates[0] & 1);
+    uint8_t changed = 0;
+    uint8_t went_down = 0;
+
+    for (uint8_t i = 0; i < KEYBOARD_SCAN_BYTES; i++) {
+        uint8_t now = keystates[i];
+        uint8_t diff = now ^ keys_last[i];
+        keys_last[i] = now;
+        changed |= diff;
+        went_down |= diff & now;
+    }
+
+    action_events = 0;
+    if (!any_down) {
+        actions_held = 0;
+        return false;
+    }
+    // Nothing changed and nothing held that could repeat
+    if (!changed && !actions_held) return false;
+
+    uint32_t held = 0;
+    uint32_t bit = 1;
+    for (uint8_t a = 0; a < NUM_ACTIONS; a++, bit <<= 1) {
+        const ActionBinding *b = &action_bindings[a];
+        if (!binding_held(b)) continue;
+        held |= bit;
+
+        if (!(actions_held & bit)) {
+            // Fresh press fires at once, then waits out the delay
+            action_events |= bit;
+            repeat_timer[a] = b->das;
+        } else if (b->das && --repeat_timer[a] == 0) {
+            action_events |= bit;
+            repeat_timer[a] = b->arr;
+        }
+    }
+    actions_held = held;
+    return went_down != 0;
+}
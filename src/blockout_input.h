@@ -13,8 +13,42 @@
 
 #define KEYBOARD_INPUT 0xFF10
 #define KEYBOARD_BYTES 32
+// Bytes holding every key we bind, up to KEY_KPEQUAL (0x67)
+#define KEYBOARD_SCAN_BYTES ((KEY_KPEQUAL >> 3) + 1)
 #define key(code) (keystates[code >> 3] & (1 << (code & 7)))
 extern uint8_t keystates[32];
-extern bool handled_key;
 
-#endif
\ No newline at end of file
+/* ================= ACTIONS ================= */
+
+typedef enum {
+    ACT_LEFT, ACT_RIGHT, ACT_UP, ACT_DOWN, ACT_RAISE, ACT_LOWER,
+    // Same order as the TURN_* directions
+    ACT_TURN_X_POS, ACT_TURN_Y_POS, ACT_TURN_Z_POS,
+    ACT_TURN_X_NEG, ACT_TURN_Y_NEG, ACT_TURN_Z_NEG,
+    ACT_DROP,           // Also starts a game from the start screen
+    ACT_PAUSE, ACT_QUIT, ACT_RESTART,
+    ACT_PIT_1, ACT_PIT_2, ACT_PIT_3, ACT_PIT_4,   // Consecutive, one per preset
+    ACT_VIEW,           // Perspective or oblique view
+    ACT_ZOOM_IN, ACT_ZOOM_OUT,
+    ACT_DEBUG_SHAPE, ACT_DEBUG_MODE, ACT_DEBUG_SHADOW, ACT_DEBUG_PROFILE,
+    NUM_ACTIONS
+} Action;
+
+typedef struct {
+    uint8_t key;
+    uint8_t alt_key;    // KEY_NONE if unused
+    uint8_t das;        // Frames held before auto-repeat starts, 0 = no repeat
+    uint8_t arr;        // Frames between repeats
+} ActionBinding;
+
+extern ActionBinding action_bindings[NUM_ACTIONS];
+
+// Actions that fired this frame: a fresh press or an auto-repeat
+extern uint32_t action_events;
+#define action(a) (action_events & ((uint32_t)1 << (a)))
+
+// Diff keystates against last frame and advance the repeat timers.
+// Returns true if any key went down.
+bool input_update(void);
+
+#endif
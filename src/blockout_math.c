@@ -2,10 +2,35 @@
 #include <stdbool.h>
 #include "blockout_types.h"
 #include "blockout_math.h"
+#ifdef BLOCKOUT_MATH_BENCH
+#include <rp6502.h>
+#endif
 
 
-int16_t grid_sx[MAX_PIT_HEIGHT + 1][MAX_PIT_DEPTH + 1][MAX_PIT_WIDTH + 1];
-int16_t grid_sy[MAX_PIT_HEIGHT + 1][MAX_PIT_DEPTH + 1];
+uint8_t grid_size;
+int16_t pit_origin_x, pit_origin_y;
+const uint8_t (*grid_sx)[MAX_PIT_WIDTH + 1];
+const uint8_t (*grid_sy)[MAX_PIT_DEPTH + 1];
+
+static uint8_t oblique_sx[MAX_PIT_HEIGHT + 1][MAX_PIT_WIDTH + 1];
+static uint8_t oblique_sy[MAX_PIT_HEIGHT + 1][MAX_PIT_DEPTH + 1];
+
+uint16_t z_step_fp = PIT_Z_STEP << 8;
+
+// Grid tables for zoom levels other than the default, filled the first
+// time a level is used with the current pit and reused until evicted
+typedef struct {
+    uint8_t zoom;       // 0xFF = empty
+    uint8_t width;
+    uint8_t depth;
+    uint8_t sx[MAX_PIT_HEIGHT + 1][MAX_PIT_WIDTH + 1];
+    uint8_t sy[MAX_PIT_HEIGHT + 1][MAX_PIT_DEPTH + 1];
+} ZoomGrid;
+
+static ZoomGrid zoom_cache[ZOOM_CACHE_SLOTS] = {
+    {0xFF, 0, 0, {{0}}, {{0}}}, {0xFF, 0, 0, {{0}}, {{0}}}
+};
+static uint8_t zoom_cache_next = 0;
 
 /* ================= LUTS ================= */
 
@@ -78,7 +103,8 @@ const int16_t cosine_values[256] = {
     4017, 4035, 4051, 4065, 4076, 4084, 4091, 4094,
 };
 
-uint16_t persp_lut[256];
+// persp_lut, quarter_squares and the grid tables
+#include "math_tables.h"
 
 const uint16_t zoom_lut[NUM_ZOOM_LEVELS] = {
     8192, 4096, 2048, 1024, 896, 768, 640, 512
@@ -90,6 +116,7 @@ const uint16_t zoom_lut[NUM_ZOOM_LEVELS] = {
 
 #define UNIT_SCALE 1024 
 
+// tools/shapes2c.py reads the corner numbering and edges from here
 const int16_t ref_vertices[8][3] = {
     {-UNIT_SCALE,-UNIT_SCALE,-UNIT_SCALE},
     { UNIT_SCALE,-UNIT_SCALE,-UNIT_SCALE},
@@ -112,9 +139,98 @@ const uint8_t edges[24] = {
 uint8_t angleX=0, angleY=0, angleZ=0;
 uint8_t targetX=0, targetY=0, targetZ=0;
 
+/* ================= ORIENTATIONS ================= */
+
+uint8_t shape_orient = 0;
+
+// One representative angle triple per orientation, fewest turns first.
+// Turns apply Y, then X, then Z, matching the renderer.
+const uint8_t orient_angles[NUM_ORIENTS][3] = {
+    {  0,   0,   0}, //  0
+    {  0,   0,  64}, //  1
+    {  0,   0, 192}, //  2
+    {  0,  64,   0}, //  3
+    {  0, 192,   0}, //  4
+    { 64,   0,   0}, //  5
+    {192,   0,   0}, //  6
+    {  0,   0, 128}, //  7
+    {  0,  64,  64}, //  8
+    {  0,  64, 192}, //  9
+    {  0, 128,   0}, // 10
+    {  0, 192,  64}, // 11
+    {  0, 192, 192}, // 12
+    { 64,   0,  64}, // 13
+    { 64,   0, 192}, // 14
+    {128,   0,   0}, // 15
+    {192,   0,  64}, // 16
+    {192,   0, 192}, // 17
+    {  0,  64, 128}, // 18
+    {  0, 128,  64}, // 19
+    {  0, 128, 192}, // 20
+    {  0, 192, 128}, // 21
+    { 64,   0, 128}, // 22
+    {192,   0, 128}, // 23
+};
+
+// Columns: X+, Y+, Z+, X-, Y-, Z-
+const uint8_t orient_next[NUM_ORIENTS][NUM_TURNS] = {
+    { 5,  3,  1,  6,  4,  2}, //  0
+    {13,  8,  7, 16, 11,  0}, //  1
+    {14,  9,  0, 17, 12,  7}, //  2
+    {13, 10,  8, 17,  0,  9}, //  3
+    {14,  0, 11, 16, 10, 12}, //  4
+    {15, 13, 13,  0, 14, 14}, //  5
+    { 0, 17, 16, 15, 16, 17}, //  6
+    {22, 18,  2, 23, 21,  1}, //  7
+    {22, 19, 18,  6,  1,  3}, //  8
+    { 5, 20,  3, 23,  2, 18}, //  9
+    {22,  4, 19, 23,  3, 20}, // 10
+    { 5,  1, 21, 23, 19,  4}, // 11
+    {22,  2,  4,  6, 20, 21}, // 12
+    {20, 22, 22,  1,  5,  5}, // 13
+    {19,  5,  5,  2, 22, 22}, // 14
+    { 6, 21, 20,  5, 18, 19}, // 15
+    { 1,  6, 23, 20, 23,  6}, // 16
+    { 2, 23,  6, 19,  6, 23}, // 17
+    {14, 15,  9, 16,  7,  8}, // 18
+    {14, 11, 15, 17,  8, 10}, // 19
+    {13, 12, 10, 16,  9, 15}, // 20
+    {13,  7, 12, 17, 15, 11}, // 21
+    {10, 14, 14,  7, 13, 13}, // 22
+    { 7, 16, 17, 10, 17, 16}, // 23
+};
+
+const int8_t orient_axes[NUM_ORIENTS][3] = {
+    { 1,  2,  3}, //  0
+    {-2,  1,  3}, //  1
+    { 2, -1,  3}, //  2
+    { 3,  2, -1}, //  3
+    {-3,  2,  1}, //  4
+    { 1, -3,  2}, //  5
+    { 1,  3, -2}, //  6
+    {-1, -2,  3}, //  7
+    {-2,  3, -1}, //  8
+    { 2, -3, -1}, //  9
+    {-1,  2, -3}, // 10
+    {-2, -3,  1}, // 11
+    { 2,  3,  1}, // 12
+    { 3,  1,  2}, // 13
+    {-3, -1,  2}, // 14
+    { 1, -2, -3}, // 15
+    {-3,  1, -2}, // 16
+    { 3, -1, -2}, // 17
+    {-3, -2, -1}, // 18
+    {-2, -1, -3}, // 19
+    { 2,  1, -3}, // 20
+    { 3, -2,  1}, // 21
+    {-1,  3,  2}, // 22
+    {-1, -3, -2}, // 23
+};
+
 /* ================= ROTATION CACHE ================= */
 
 uint8_t last_ax=255, last_ay=255, last_az=255;
+uint8_t last_orient=255;
 uint8_t last_shape=255;
 uint8_t last_zoom=255;
 
@@ -130,37 +246,128 @@ int16_t scaled_block_centers[MAX_BLOCKS][3];
 int16_t px[8], py[8];
 
 
-/* ================= PRECOMPUTE ================= */
+/* ================= GRID ================= */
+
+// The oblique grid is regular: every layer is the front ring moved by
+// oblique_shift(), so it is built with adds alone. The cell size leaves
+// room for the whole shifted stack within viewport columns and rows
+// 0..VIEWPORT_WIDTH-1, and the stack is centred there. tools/tables2c.py
+// checks that every pit size fits.
+static void build_oblique_tables(uint8_t span) {
+    grid_size = (4 * (VIEWPORT_WIDTH - 1)) / (4 * span + PIT_HEIGHT);
+    int16_t depth = oblique_shift((int16_t)PIT_HEIGHT * grid_size);
+    pit_origin_x = (VIEWPORT_WIDTH - 1 - (int16_t)(PIT_WIDTH * grid_size + depth)) / 2 - SCREEN_CENTER_X;
+    pit_origin_y = (VIEWPORT_HEIGHT - 1 - (int16_t)(PIT_DEPTH * grid_size + depth)) / 2 - SCREEN_CENTER_Y;
+
+    int16_t zw = 0;
+    for (uint8_t z = 0; z <= PIT_HEIGHT; z++, zw += grid_size) {
+        int16_t sx = SCREEN_CENTER_X + pit_origin_x + oblique_shift(zw);
+        int16_t sy = SCREEN_CENTER_Y + pit_origin_y + oblique_shift(zw);
+        for (uint8_t x = 0; x <= PIT_WIDTH; x++, sx += grid_size) oblique_sx[z][x] = (uint8_t)sx;
+        for (uint8_t y = 0; y <= PIT_DEPTH; y++, sy += grid_size) oblique_sy[z][y] = (uint8_t)sy;
+    }
+    grid_sx = oblique_sx;
+    grid_sy = oblique_sy;
+}
+
+// Project one axis of the grid at the current zoom. The front layer is
+// at PIT_Z_START whatever the zoom, so the points stay in the viewport.
+static void project_zoom_axis(uint8_t (*screen)[MAX_PIT_WIDTH + 1], int16_t origin, uint8_t lines) {
+    uint32_t zi_fp = (uint32_t)PIT_Z_START << 8;
+    for (uint8_t z = 0; z <= MAX_PIT_HEIGHT; z++, zi_fp += z_step_fp) {
+        uint8_t zi = (zi_fp > 0xFF00) ? 255 : (uint8_t)(zi_fp >> 8);
+        int16_t w = origin;
+        for (uint8_t i = 0; i <= lines; i++, w += grid_size) {
+            screen[z][i] = (uint8_t)(apply_perspective_fast(w, zi) + SCREEN_CENTER_X);
+        }
+    }
+}
+
+static const ZoomGrid *zoom_grid(void) {
+    ZoomGrid *g;
+    for (uint8_t i = 0; i < ZOOM_CACHE_SLOTS; i++) {
+        g = &zoom_cache[i];
+        if (g->zoom == zoom_level && g->width == PIT_WIDTH && g->depth == PIT_DEPTH) return g;
+    }
+    g = &zoom_cache[zoom_cache_next];
+    zoom_cache_next = (zoom_cache_next + 1) % ZOOM_CACHE_SLOTS;
+    g->zoom = zoom_level;
+    g->width = PIT_WIDTH;
+    g->depth = PIT_DEPTH;
+    project_zoom_axis(g->sx, pit_origin_x, PIT_WIDTH);
+    project_zoom_axis(g->sy, pit_origin_y, PIT_DEPTH);
+    return g;
+}
+
+static uint16_t zoom_step_fp(uint8_t level) {
+    return (uint16_t)(((uint32_t)PIT_Z_STEP << 18) / zoom_lut[level]);
+}
+
+// The back ring of the pit must stay short of the depth clamp in
+// project_zoom_axis(), or the deepest layers collapse onto one ring
+bool zoom_fits(uint8_t level) {
+    return ((uint32_t)PIT_Z_START << 8) + (uint32_t)PIT_HEIGHT * zoom_step_fp(level) <= 0xFF00;
+}
 
-void precompute_tables(void) {
-    persp_lut[0]=65535;
-    for(uint16_t i=1;i<256;i++) persp_lut[i]=65536U/i;
+// Every grid point lies inside the front ring, which spans at most the
+// viewport, so each coordinate fits in a byte. A resize does no
+// arithmetic, it only picks the tables for the new extents; another zoom
+// level is projected once and then cached.
+void select_grid_tables(void) {
+    uint8_t span = (PIT_WIDTH > PIT_DEPTH) ? PIT_WIDTH : PIT_DEPTH;
+    // A taller pit pulls the zoom back to the deepest level that fits
+    while (!zoom_fits(zoom_level)) zoom_level--;
+    if (!perspective_enabled) {
+        build_oblique_tables(span);
+        return;
+    }
+    const uint8_t *index = grid_axis_index[span - MIN_PIT_WIDTH];
+    const GridAxis *ax = &grid_axes[index[PIT_WIDTH - MIN_PIT_WIDTH]];
+    const GridAxis *ay = &grid_axes[index[PIT_DEPTH - MIN_PIT_DEPTH]];
+
+    grid_size = grid_cell_sizes[span];
+    pit_origin_x = ax->origin;
+    pit_origin_y = ay->origin;
+    z_step_fp = zoom_step_fp(zoom_level);
+
+    if (zoom_level == ZOOM_DEFAULT) {
+        grid_sx = ax->screen;
+        grid_sy = ay->screen;
+    } else {
+        const ZoomGrid *g = zoom_grid();
+        grid_sx = g->sx;
+        grid_sy = g->sy;
+    }
 }
 
-// Precompute ALL screen coordinates once. 
-void precompute_grid_coordinates(void) {
-    int16_t grid_x = GRID_SIZE;
-    int16_t grid_y = GRID_SIZE;
-    int16_t centerX = SCREEN_CENTER_X + VIEWPORT_X;
-    int16_t centerY = SCREEN_CENTER_Y + VIEWPORT_Y;
-
-    for (uint8_t z = 0; z <= PIT_HEIGHT; z++) {
-        uint16_t zi = PIT_Z_START + (z * PIT_Z_STEP);
-        
-        for (uint8_t y = 0; y <= PIT_DEPTH; y++) {
-            int16_t wy = (y * grid_y) - (VIEWPORT_HEIGHT / 2);
-            int16_t py = apply_perspective(wy, (uint8_t)zi) + centerY;
-            grid_sy[z][y] = py;
-
-            for (uint8_t x = 0; x <= PIT_WIDTH; x++) {
-                int16_t wx = (x * grid_x) - (VIEWPORT_WIDTH / 2);
-                int16_t px = apply_perspective(wx, (uint8_t)zi) + centerX;
-
-                grid_sx[z][y][x] = px;
-            }
+#ifdef BLOCKOUT_MATH_BENCH
+uint16_t bench_perspective(uint8_t *ticks_slow, uint8_t *ticks_fast) {
+    volatile int16_t sink;
+    uint16_t mismatches = 0;
+    uint8_t t;
+
+    for (uint16_t zi = 1; zi < 256; zi++) {
+        for (int16_t v = -255; v <= 255; v++) {
+            if (apply_perspective_fast(v, (uint8_t)zi) != apply_perspective(v, (uint8_t)zi)) mismatches++;
         }
     }
+
+    t = RIA.vsync;
+    for (uint16_t zi = PIT_Z_START; zi < 256; zi++) {
+        for (int16_t v = -WORLD_HALF_W; v <= WORLD_HALF_W; v++) sink = apply_perspective(v, (uint8_t)zi);
+    }
+    *ticks_slow = RIA.vsync - t;
+
+    t = RIA.vsync;
+    for (uint16_t zi = PIT_Z_START; zi < 256; zi++) {
+        for (int16_t v = -WORLD_HALF_W; v <= WORLD_HALF_W; v++) sink = apply_perspective_fast(v, (uint8_t)zi);
+    }
+    *ticks_fast = RIA.vsync - t;
+
+    (void)sink;
+    return mismatches;
 }
+#endif
 
 /* ================= ROTATION ================= */
 
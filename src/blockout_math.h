@@ -11,14 +11,45 @@ extern const int16_t sine_values[256];
 extern const int16_t cosine_values[256];
 
 
-extern uint16_t persp_lut[256];
+// 65536 / z; this and the other projection tables are generated at
+// build time by tools/tables2c.py
+extern const uint16_t persp_lut[256];
 
+// Camera zoom in 1/1024: the layer spacing in depth is PIT_Z_STEP scaled
+// by 1024 / zoom, so higher zoom flattens the pit and brings the far
+// layers closer while the front ring keeps its place
 extern const uint16_t zoom_lut[NUM_ZOOM_LEVELS];
 
-// Cache for screen coordinates of every grid point
-// Dimensions: [Z levels][Depth Y][Width X]
-extern int16_t grid_sx[MAX_PIT_HEIGHT + 1][MAX_PIT_DEPTH + 1][MAX_PIT_WIDTH + 1];
-extern int16_t grid_sy[MAX_PIT_HEIGHT + 1][MAX_PIT_DEPTH + 1];
+// Depth units per layer at the current zoom, 8.8 fixed point
+extern uint16_t z_step_fp;
+
+// Cell size in world units, so the wider side of the pit fills the viewport
+extern uint8_t grid_size;
+#define CUBE_SIZE (grid_size / 2)
+
+// World position of the pit's (0, 0) corner; the pit is centred
+extern int16_t pit_origin_x, pit_origin_y;
+
+// Cell size by the pit's wider side
+extern const uint8_t grid_cell_sizes[MAX_PIT_WIDTH + 1];
+
+// Grid lines along one horizontal axis, for one pit extent and cell size.
+// Perspective scales x and y independently, so a layer needs one row of
+// x and one row of y; the viewport is square and x and y share tables.
+typedef struct {
+    int16_t origin;                                         // World position of line 0
+    uint8_t screen[MAX_PIT_HEIGHT + 1][MAX_PIT_WIDTH + 1];  // [Z level][line], viewport-relative
+} GridAxis;
+
+// Screen coordinates of every grid point for the current pit, pointing
+// into the generated tables, or into the oblique tables when perspective
+// is off. Dimensions: [Z levels][X or Y]
+extern const uint8_t (*grid_sx)[MAX_PIT_WIDTH + 1];
+extern const uint8_t (*grid_sy)[MAX_PIT_DEPTH + 1];
+
+// Grid point positions in the static buffer
+#define GRID_X(z, x) ((int16_t)grid_sx[z][x] + VIEWPORT_X)
+#define GRID_Y(z, y) ((int16_t)grid_sy[z][y] + VIEWPORT_Y)
 
 
 /* ================= GEOMETRY ================= */
@@ -34,9 +65,31 @@ extern const uint8_t edges[24];
 extern uint8_t angleX, angleY, angleZ;
 extern uint8_t targetX, targetY, targetZ;
 
+/* ================= ORIENTATIONS ================= */
+
+// The 24 quarter-turn orientations of a cube. Index 0 is the spawn pose.
+#define NUM_ORIENTS 24
+
+// Turn directions, in the order of the Q W E A S D rotation keys
+enum {
+    TURN_X_POS, TURN_Y_POS, TURN_Z_POS,
+    TURN_X_NEG, TURN_Y_NEG, TURN_Z_NEG,
+    NUM_TURNS
+};
+
+extern uint8_t shape_orient;
+
+// Canonical (X, Y, Z) angles of each orientation
+extern const uint8_t orient_angles[NUM_ORIENTS][3];
+// Orientation reached by turning 90 degrees in each direction
+extern const uint8_t orient_next[NUM_ORIENTS][NUM_TURNS];
+// Rotated axis i = sign * source axis (|v| - 1)
+extern const int8_t orient_axes[NUM_ORIENTS][3];
+
 /* ================= ROTATION CACHE ================= */
 
 extern uint8_t last_ax, last_ay, last_az;
+extern uint8_t last_orient;
 extern uint8_t last_shape;
 extern uint8_t last_zoom;
 
@@ -51,14 +104,56 @@ extern int16_t scaled_block_centers[MAX_BLOCKS][3];
 
 extern int16_t px[8], py[8];
 
+// Oblique view: a point's screen offset from its world position
+static inline int16_t oblique_shift(int16_t world_z) {
+    return world_z >> OBLIQUE_DEPTH_SHIFT;
+}
+
 static inline int16_t apply_perspective(int16_t v, uint8_t zi) {
     return (v * (int32_t)persp_lut[zi]) >> 10;
 }
 
-/* ================= PRECOMPUTE ================= */
+// Quarter squares, n * n / 4 for n = 0..510
+extern const uint16_t quarter_squares[511];
+
+// 8x8 multiply as a * b = (a + b)^2 / 4 - (a - b)^2 / 4
+static inline uint16_t mul_u8(uint8_t a, uint8_t b) {
+    uint8_t d = (a > b) ? (a - b) : (b - a);
+    return quarter_squares[(uint16_t)a + b] - quarter_squares[d];
+}
+
+// apply_perspective without the 32-bit multiply. For |v| < 256 the
+// product is two 8x8 lookups on the low and high byte of the scale, and
+// the shift is done in 16 bits: (lo + (hi << 8)) >> 10 is
+// ((lo >> 8) + hi) >> 2. Negative values round toward minus infinity as
+// the arithmetic shift does, so the result is identical for every input.
+static inline int16_t apply_perspective_fast(int16_t v, uint8_t zi) {
+    if (v > 255 || v < -255) return apply_perspective(v, zi);
+
+    uint16_t scale = persp_lut[zi];
+    uint8_t a = (v < 0) ? (uint8_t)-v : (uint8_t)v;
+    uint16_t lo = mul_u8(a, (uint8_t)scale);
+    uint16_t t = (lo >> 8) + mul_u8(a, scale >> 8);
+
+    if (v >= 0) return t >> 2;
+    t += ((uint8_t)lo != 0);   // Round the magnitude up instead
+    return -(int16_t)((t + 3) >> 2);
+}
+
+/* ================= GRID ================= */
+
+// Whether every layer of the current pit gets its own depth at a zoom level
+bool zoom_fits(uint8_t level);
+
+// Point the grid at the tables for the current pit dimensions and view
+void select_grid_tables(void);
 
-void precompute_tables(void);
-void precompute_grid_coordinates(void);
+#ifdef BLOCKOUT_MATH_BENCH
+// Compares apply_perspective_fast with apply_perspective over the whole
+// byte range of v and every depth. Returns the number of mismatches and
+// the vsyncs each version took in *ticks_slow and *ticks_fast.
+uint16_t bench_perspective(uint8_t *ticks_slow, uint8_t *ticks_fast);
+#endif
 
 /* ================= ROTATION ================= */
 
@@ -6,40 +6,103 @@
 #include "blockout_shapes.h"
 #include "blockout_pit.h"
 #include "blockout_render.h"
+#include "blockout_dlist.h"
 #include "sound.h"
 
 
-uint8_t pit[MAX_PIT_HEIGHT][MAX_PIT_DEPTH][MAX_PIT_WIDTH];           // 1 if block present
-uint8_t pit_colors[MAX_PIT_HEIGHT][MAX_PIT_DEPTH][MAX_PIT_WIDTH];    // Color of each block
+uint8_t pit_rows[MAX_PIT_HEIGHT][MAX_PIT_DEPTH];                    // Bit x set if block present
+const uint8_t pit_bit[8] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
 const uint8_t layer_colors[MAX_PIT_HEIGHT] = {
-    DARK_GRAY, DARK_BLUE, BROWN, DARK_MAGENTA, DARK_CYAN, DARK_RED, DARK_GREEN, DARK_BLUE
+    DARK_GRAY, DARK_BLUE, BROWN, DARK_MAGENTA, DARK_CYAN, DARK_RED,
+    DARK_GREEN, DARK_BLUE, BROWN, DARK_MAGENTA, DARK_CYAN, DARK_RED
 };
+uint8_t column_top[MAX_PIT_DEPTH][MAX_PIT_WIDTH];                   // Topmost occupied z, PIT_HEIGHT if empty
 
 
-bool is_layer_complete(uint8_t z) {
+/* ================= HEIGHTMAP ================= */
+
+static uint8_t scan_column_top(uint8_t x, uint8_t y, uint8_t from_z) {
+    uint8_t z = from_z;
+    while (z < PIT_HEIGHT && !pit_cell(x, y, z)) z++;
+    return z;
+}
+
+void rebuild_column_tops(void) {
     for (uint8_t y = 0; y < PIT_DEPTH; y++) {
         for (uint8_t x = 0; x < PIT_WIDTH; x++) {
-            if (!pit[z][y][x]) return false;
+            column_top[y][x] = scan_column_top(x, y, 0);
+        }
+    }
+}
+
+void pit_clear(void) {
+    for (uint8_t z = 0; z < MAX_PIT_HEIGHT; z++) {
+        for (uint8_t y = 0; y < MAX_PIT_DEPTH; y++) {
+            pit_rows[z][y] = 0;
+        }
+    }
+    for (uint8_t y = 0; y < MAX_PIT_DEPTH; y++) {
+        for (uint8_t x = 0; x < MAX_PIT_WIDTH; x++) {
+            column_top[y][x] = PIT_HEIGHT;
         }
     }
+}
+
+// Resting z of the current shape dropped straight down from (px, py, pz).
+// While every block is above its column top the answer is a few lookups;
+// a block tucked under an overhang falls back to probing the pit.
+int8_t landing_z(uint8_t orient, int8_t px, int8_t py, int8_t pz) {
+    const Shape *s = &shapes[current_shape_idx];
+    int8_t land = PIT_HEIGHT;
+
+    for (uint8_t b = 0; b < s->num_blocks; b++) {
+        int8_t rx, ry, rz;
+        get_rotated_offset(b, orient, &rx, &ry, &rz);
+        uint8_t top = column_top[py + ry][px + rx];
+        if (pz + rz >= (int8_t)top) {
+            while (is_rotation_valid_at(orient, px, py, pz + 1)) pz++;
+            return pz;
+        }
+        int8_t limit = (int8_t)top - 1 - rz;
+        if (limit < land) land = limit;
+    }
+    return land;
+}
+
+
+bool is_layer_complete(uint8_t z) {
+    uint8_t full = pit_row_full();
+    for (uint8_t y = 0; y < PIT_DEPTH; y++) {
+        if (pit_rows[z][y] != full) return false;
+    }
     return true;
 }
 
+bool is_layer_empty(uint8_t z) {
+    uint8_t any = 0;
+    for (uint8_t y = 0; y < PIT_DEPTH; y++) {
+        any |= pit_rows[z][y];
+    }
+    return any == 0;
+}
+
 void clear_layer(uint8_t z) {
-    // Shift all layers above down using 8-bit counters
+    // Shift all layers above down, a whole row per byte
     for (int8_t zz = z; zz > 0; zz--) {
         for (uint8_t y = 0; y < PIT_DEPTH; y++) {
-            for (uint8_t x = 0; x < PIT_WIDTH; x++) {
-                pit[zz][y][x] = pit[zz-1][y][x];
-                pit_colors[zz][y][x] = pit_colors[zz-1][y][x];
-            }
+            pit_rows[zz][y] = pit_rows[zz-1][y];
         }
     }
     // Clear top layer
+    for (uint8_t y = 0; y < PIT_DEPTH; y++) {
+        pit_rows[0][y] = 0;
+    }
+    // A full layer caps every column at or above z. Columns topped
+    // higher just moved down one; columns topped at z lost their top.
     for (uint8_t y = 0; y < PIT_DEPTH; y++) {
         for (uint8_t x = 0; x < PIT_WIDTH; x++) {
-            pit[0][y][x] = 0;
-            pit_colors[0][y][x] = 0;
+            if (column_top[y][x] < z) column_top[y][x]++;
+            else if (column_top[y][x] == z) column_top[y][x] = scan_column_top(x, y, z + 1);
         }
     }
     lines_cleared++;
@@ -55,8 +118,8 @@ void check_and_clear_layers(void) {
         if (is_layer_complete((uint8_t)z)) {
             if (deepest_cleared == -1) {
                 trigger_screen_shake();
-                play_clear_level_sound();
             }
+            post_sound(SOUND_CLEAR_LAYER);
             clear_layer((uint8_t)z);
             if (z > deepest_cleared) deepest_cleared = z;
             z++; 
@@ -64,6 +127,8 @@ void check_and_clear_layers(void) {
     }
 
     if (deepest_cleared != -1) {
+        // Emptying the whole pit gets its own chime over the layer sweeps
+        if (count_occupied_levels() == 0) post_sound(SOUND_CLEAR_ALL);
         state.full_redraw_pending = true;
         state.need_static_redraw = true;
     }
@@ -75,16 +140,16 @@ void redraw_region(int8_t min_x, int8_t max_x, int8_t min_y, int8_t max_y) {
     for (int8_t y = min_y; y <= max_y; y++) {
         for (int8_t x = min_x; x <= max_x; x++) {
             for (uint8_t z = 0; z < PIT_HEIGHT; z++) {
-                if (pit[z][y][x]) {
-                    int16_t fx0 = grid_sx[z][y][x];
-                    int16_t fx1 = grid_sx[z][y][x+1];
-                    int16_t fx2 = grid_sx[z][y+1][x+1];
-                    int16_t fx3 = grid_sx[z][y+1][x];
-                    int16_t fy0 = grid_sy[z][y];
-                    int16_t fy1 = grid_sy[z][y];
-                    int16_t fy2 = grid_sy[z][y+1];
-                    int16_t fy3 = grid_sy[z][y+1];
-                    draw_poly_fast(STATIC_BUFFER_ADDR, fx0, fy0, fx1, fy1, fx2, fy2, fx3, fy3, BLACK, 1);
+                if (pit_cell(x, y, z)) {
+                    int16_t fx0 = GRID_X(z, x);
+                    int16_t fx1 = GRID_X(z, x+1);
+                    int16_t fx2 = GRID_X(z, x+1);
+                    int16_t fx3 = GRID_X(z, x);
+                    int16_t fy0 = GRID_Y(z, y);
+                    int16_t fy1 = GRID_Y(z, y);
+                    int16_t fy2 = GRID_Y(z, y+1);
+                    int16_t fy3 = GRID_Y(z, y+1);
+                    draw_poly_fast(fx0, fy0, fx1, fy1, fx2, fy2, fx3, fy3, BLACK, 1);
                 }
             }
         }
@@ -93,12 +158,13 @@ void redraw_region(int8_t min_x, int8_t max_x, int8_t min_y, int8_t max_y) {
     for (int8_t z = PIT_HEIGHT - 1; z >= 0; z--) {
         for (int8_t y = max_y; y >= min_y; y--) {
             for (int8_t x = min_x; x <= max_x; x++) {
-                if (pit[z][y][x]) {
-                    draw_cube_at(STATIC_BUFFER_ADDR, x, y, z, layer_colors[z]);
+                if (pit_cell(x, y, z)) {
+                    draw_cube_at(x, y, z, layer_colors[z]);
                 }
             }
         }
     }
+    dl_flush();
 }
 
 void lock_shape(void) {
@@ -110,14 +176,14 @@ void lock_shape(void) {
     
     for (uint8_t b = 0; b < s->num_blocks; b++) {
         int8_t rx, ry, rz;
-        get_rotated_offset(b, targetX, targetY, targetZ, &rx, &ry, &rz);
+        get_rotated_offset(b, shape_orient, &rx, &ry, &rz);
         int8_t ax = shape_pos_x + rx;
         int8_t ay = shape_pos_y + ry;
         int8_t az = shape_pos_z + rz;
         
         if (az >= 0 && az < PIT_HEIGHT && ax >= 0 && ax < PIT_WIDTH && ay >= 0 && ay < PIT_DEPTH) {
-            pit[az][ay][ax] = 1;
-            pit_colors[az][ay][ax] = layer_colors[az];
+            pit_set(ax, ay, az);
+            if (az < column_top[ay][ax]) column_top[ay][ax] = az;
             
             if (ax < min_x) min_x = ax;
             if (ax > max_x) max_x = ax;
@@ -150,19 +216,7 @@ uint8_t count_occupied_levels(void) {
     uint8_t count = 0;
     
     for (uint8_t z = 0; z < PIT_HEIGHT; z++) {
-        bool level_has_blocks = false;
-        
-        for (uint8_t y = 0; y < PIT_DEPTH; y++) {
-            for (uint8_t x = 0; x < PIT_WIDTH; x++) {
-                if (pit[z][y][x]) {
-                    level_has_blocks = true;
-                    break; 
-                }
-            }
-            if (level_has_blocks) break; 
-        }
-        
-        if (level_has_blocks) {
+        if (!is_layer_empty(z)) {
             count++;
         }
     }
@@ -8,9 +8,35 @@
 #include "blockout_shapes.h"
 
 
-extern uint8_t pit[MAX_PIT_HEIGHT][MAX_PIT_DEPTH][MAX_PIT_WIDTH];           // 1 if block present
-extern uint8_t pit_colors[MAX_PIT_HEIGHT][MAX_PIT_DEPTH][MAX_PIT_WIDTH];    // Color of each block
+extern uint8_t pit_rows[MAX_PIT_HEIGHT][MAX_PIT_DEPTH];             // Bit x set if block present
+extern const uint8_t pit_bit[8];                                     // 1 << x without the shift loop
 extern const uint8_t layer_colors[MAX_PIT_HEIGHT];
+extern uint8_t column_top[MAX_PIT_DEPTH][MAX_PIT_WIDTH];            // Topmost occupied z, PIT_HEIGHT if empty
+
+static inline bool pit_cell(uint8_t x, uint8_t y, uint8_t z) {
+    return (pit_rows[z][y] & pit_bit[x]) != 0;
+}
+
+static inline void pit_set(uint8_t x, uint8_t y, uint8_t z) {
+    pit_rows[z][y] |= pit_bit[x];
+}
+
+static inline void pit_reset(uint8_t x, uint8_t y, uint8_t z) {
+    pit_rows[z][y] &= (uint8_t)~pit_bit[x];
+}
+
+// Bits of a row that is full across the current pit width
+static inline uint8_t pit_row_full(void) {
+    return (uint8_t)(pit_bit[PIT_WIDTH] - 1);
+}
+
+bool is_layer_empty(uint8_t z);
+
+void rebuild_column_tops(void);
+
+void pit_clear(void);
+
+int8_t landing_z(uint8_t orient, int8_t px, int8_t py, int8_t pz);
 
 bool is_layer_complete(uint8_t z);
 
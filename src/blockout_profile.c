@@ -0,0 +1,83 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "colors.h"
+#include "bitmap_graphics_db.h"
+#include "blockout_types.h"
+#include "blockout_profile.h"
+
+#define PROFILE_X 226
+#define PROFILE_Y 172
+#define PROFILE_W 88
+#define PROFILE_H 8
+
+uint16_t frame_count = 0;
+uint8_t frame_time = 1;             // Vsyncs covered by the last loop pass
+
+static uint8_t last_vsync;
+static uint8_t latency = 0;         // Last measured input-to-display latency
+static uint16_t probe_start;
+static bool probe_armed = false;
+
+static bool profile_enabled = false;
+static bool profile_shown = false;
+static uint8_t shown_frame_time = 0xFF;
+static uint8_t shown_latency = 0xFF;
+
+void profile_frame_begin(uint8_t vsync) {
+    frame_time = vsync - last_vsync;
+    last_vsync = vsync;
+    frame_count += frame_time;
+}
+
+void profile_key_down(void) {
+    if (probe_armed) return;
+    probe_start = frame_count;
+    probe_armed = true;
+}
+
+void profile_flip(void) {
+    if (!probe_armed) return;
+    // The new buffer is scanned out from the next vsync on
+    uint16_t frames = frame_count - probe_start + 1;
+    latency = (frames > 99) ? 99 : (uint8_t)frames;
+    probe_armed = false;
+}
+
+void profile_no_flip(void) {
+    // A hard drop shows one frame after its key, anything later never will
+    if (probe_armed && frame_count - probe_start >= 2) {
+        probe_armed = false;
+    }
+}
+
+void profile_toggle(void) {
+    profile_enabled = !profile_enabled;
+}
+
+void draw_profile_overlay(uint16_t buf) {
+    if (!profile_enabled) {
+        if (profile_shown) {
+            restore_rect(PROFILE_X, PROFILE_Y, PROFILE_W, PROFILE_H, buf, PROFILE_SAVE_ADDR);
+            profile_shown = false;
+        }
+        return;
+    }
+
+    if (!profile_shown) {
+        save_rect(PROFILE_X, PROFILE_Y, PROFILE_W, PROFILE_H, buf, PROFILE_SAVE_ADDR);
+        profile_shown = true;
+        shown_frame_time = shown_latency = 0xFF;
+    }
+    if (frame_time == shown_frame_time && latency == shown_latency) return;
+
+    char text[16];
+    sprintf(text, "FT %u LAT %u", frame_time, latency);
+    fill_rect2buffer(BLACK, PROFILE_X, PROFILE_Y, PROFILE_W, PROFILE_H, buf);
+    set_text_multiplier(1);
+    set_text_color(LIGHT_GRAY);
+    set_cursor(PROFILE_X + 2, PROFILE_Y + 1);
+    draw_string2buffer(text, buf);
+    shown_frame_time = frame_time;
+    shown_latency = latency;
+}
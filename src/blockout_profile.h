@@ -0,0 +1,28 @@
+#ifndef BLOCKOUT_PROFILE_H
+#define BLOCKOUT_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ================= PROFILER ================= */
+
+// Frame counter in vsyncs, advanced once per main loop pass
+extern uint16_t frame_count;
+// Vsyncs covered by the last main loop pass
+extern uint8_t frame_time;
+
+// Mark the top of a main loop pass; counts the vsyncs it has covered
+void profile_frame_begin(uint8_t vsync);
+
+// Latency probe: armed by a key going down, closed by the next flip.
+// Results are in frames from sampling the key to the frame it shows.
+void profile_key_down(void);
+void profile_flip(void);
+// A pass without a flip; drops a probe whose key changed nothing on screen
+void profile_no_flip(void);
+
+// Overlay on the static plane, drawn only when a value changes
+void profile_toggle(void);
+void draw_profile_overlay(uint16_t buf);
+
+#endif
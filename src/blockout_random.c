@@ -0,0 +1,56 @@
+#include <stdint.h>
+#include "blockout_types.h"
+#include "blockout_random.h"
+
+static uint16_t rng_state = 1;
+
+static uint8_t bag[NUM_SHAPES];
+static uint8_t bag_left = 0;
+
+void rng_seed(uint16_t s) {
+    // Zero is the one state xorshift never leaves
+    rng_state = s ? s : 0xACE1;
+    bag_left = 0;
+}
+
+// Triple (7, 9, 8): full period of 65535 using only byte-friendly shifts
+uint16_t rng_next16(void) {
+    rng_state ^= rng_state << 7;
+    rng_state ^= rng_state >> 9;
+    rng_state ^= rng_state << 8;
+    return rng_state;
+}
+
+uint8_t rng_next8(void) {
+    return (uint8_t)(rng_next16() >> 8);
+}
+
+// Mask down to the next power of two and reject values past the end.
+// At worst half the draws are rejected, so the loop stays short.
+uint8_t rng_range(uint8_t n) {
+    uint8_t mask = n - 1;
+    mask |= mask >> 1;
+    mask |= mask >> 2;
+    mask |= mask >> 4;
+
+    uint8_t r;
+    do {
+        r = rng_next8() & mask;
+    } while (r >= n);
+    return r;
+}
+
+uint8_t bag_next(void) {
+    if (bag_left == 0) {
+        // Refill and Fisher-Yates shuffle
+        for (uint8_t i = 0; i < NUM_SHAPES; i++) bag[i] = i;
+        for (uint8_t i = NUM_SHAPES - 1; i > 0; i--) {
+            uint8_t j = rng_range(i + 1);
+            uint8_t t = bag[i];
+            bag[i] = bag[j];
+            bag[j] = t;
+        }
+        bag_left = NUM_SHAPES;
+    }
+    return bag[--bag_left];
+}
@@ -0,0 +1,21 @@
+#ifndef BLOCKOUT_RANDOM_H
+#define BLOCKOUT_RANDOM_H
+
+#include <stdint.h>
+
+/* ================= RANDOM ================= */
+
+// 16-bit xorshift, seeded once per game so a seed replays the same pieces
+void rng_seed(uint16_t s);
+uint16_t rng_next16(void);
+uint8_t rng_next8(void);
+
+// Uniform value in [0, n), n > 0, without a division
+uint8_t rng_range(uint8_t n);
+
+/* ================= SHAPE BAG ================= */
+
+// Deals every shape once, in shuffled order, before any repeats
+uint8_t bag_next(void);
+
+#endif
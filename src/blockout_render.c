@@ -8,94 +8,87 @@
 #include "blockout_pit.h"
 #include "blockout_render.h"
 #include "blockout_state.h"
+#include "blockout_dlist.h"
 #include "bitmap_graphics_db.h"
 
 
 /* ================= PIT BACKGROUND ================= */
 
-void draw_pit_background(uint16_t buf) {
-    int16_t grid_size_x = VIEWPORT_WIDTH / PIT_WIDTH;
-    int16_t grid_size_y = VIEWPORT_HEIGHT / PIT_DEPTH;
-    
-    int16_t centerX = SCREEN_CENTER_X + VIEWPORT_X;
-    int16_t centerY = SCREEN_CENTER_Y + VIEWPORT_Y;
-
-    uint16_t zi_front = PIT_Z_START;
-    uint16_t zi_back = PIT_Z_START + (PIT_HEIGHT * PIT_Z_STEP);
+// Walls are drawn through the cached grid points, so the lines meet the
+// cubes exactly whatever the pit's width, depth and height. The ring and
+// wall passes are separate so a resize can spread them over frames.
+
+// The rectangular "ring" at depth level z
+void draw_pit_ring(uint8_t z) {
+    int16_t x0 = GRID_X(z, 0);
+    int16_t y0 = GRID_Y(z, 0);
+    int16_t x1 = GRID_X(z, PIT_WIDTH);
+    int16_t y1 = GRID_Y(z, PIT_DEPTH);
+
+    dl_line(GREEN, x0, y0, x1, y0);
+    dl_line(GREEN, x1, y0, x1, y1);
+    dl_line(GREEN, x1, y1, x0, y1);
+    dl_line(GREEN, x0, y1, x0, y0);
+}
 
-    // 1. Draw the rectangular "rings" for each depth level
-    for (uint8_t i = 0; i <= PIT_HEIGHT; i++) {
-        uint16_t zi = PIT_Z_START + (i * PIT_Z_STEP);
-        if (zi > 255) zi = 255;
-
-        int16_t x0 = apply_perspective(-WORLD_HALF_W, (uint8_t)zi) + centerX;
-        int16_t y0 = apply_perspective(-WORLD_HALF_H, (uint8_t)zi) + centerY;
-        int16_t x1 = apply_perspective(WORLD_HALF_W, (uint8_t)zi) + centerX;
-        int16_t y1 = apply_perspective(WORLD_HALF_H, (uint8_t)zi) + centerY;
-
-        draw_line2buffer(GREEN, x0, y0, x1, y0, buf); 
-        draw_line2buffer(GREEN, x1, y0, x1, y1, buf); 
-        draw_line2buffer(GREEN, x1, y1, x0, y1, buf); 
-        draw_line2buffer(GREEN, x0, y1, x0, y0, buf); 
-    }
+// The depth lines along the walls and the grid on the back wall
+void draw_pit_walls(void) {
+    uint8_t back = PIT_HEIGHT;
 
-    // 2. Draw the depth lines 
-    for (int16_t x = -WORLD_HALF_W; x <= WORLD_HALF_W; x += grid_size_x) {
-        int16_t fx = apply_perspective(x, (uint8_t)zi_front) + centerX;
-        int16_t bx = apply_perspective(x, (uint8_t)zi_back) + centerX;
+    int16_t fy_top = GRID_Y(0, 0);
+    int16_t by_top = GRID_Y(back, 0);
+    int16_t fy_bot = GRID_Y(0, PIT_DEPTH);
+    int16_t by_bot = GRID_Y(back, PIT_DEPTH);
 
-        int16_t fy_top = apply_perspective(-WORLD_HALF_H, (uint8_t)zi_front) + centerY;
-        int16_t by_top = apply_perspective(-WORLD_HALF_H, (uint8_t)zi_back) + centerY;
-        int16_t fy_bot = apply_perspective(WORLD_HALF_H, (uint8_t)zi_front) + centerY;
-        int16_t by_bot = apply_perspective(WORLD_HALF_H, (uint8_t)zi_back) + centerY; 
+    for (uint8_t x = 0; x <= PIT_WIDTH; x++) {
+        int16_t fx = GRID_X(0, x);
+        int16_t bx = GRID_X(back, x);
 
         // Side walls (depth lines)
-        draw_line2buffer(GREEN, fx, fy_top, bx, by_top, buf);
-        draw_line2buffer(GREEN, fx, fy_bot, bx, by_bot, buf);
-        
-        draw_line2buffer(GREEN, bx, by_top, bx, by_bot, buf);
+        dl_line(GREEN, fx, fy_top, bx, by_top);
+        dl_line(GREEN, fx, fy_bot, bx, by_bot);
+
+        dl_line(GREEN, bx, by_top, bx, by_bot);
     }
 
-    for (int16_t y = -WORLD_HALF_H; y <= WORLD_HALF_H; y += grid_size_y) {
-        int16_t fy = apply_perspective(y, (uint8_t)zi_front) + centerY;
-        int16_t by = apply_perspective(y, (uint8_t)zi_back) + centerY;
+    int16_t fx_left = GRID_X(0, 0);
+    int16_t bx_left = GRID_X(back, 0);
+    int16_t fx_right = GRID_X(0, PIT_WIDTH);
+    int16_t bx_right = GRID_X(back, PIT_WIDTH);
 
-        int16_t fx_left = apply_perspective(-WORLD_HALF_W, (uint8_t)zi_front) + centerX;
-        int16_t bx_left = apply_perspective(-WORLD_HALF_W, (uint8_t)zi_back) + centerX;
-        int16_t fx_right = apply_perspective(WORLD_HALF_W, (uint8_t)zi_front) + centerX;
-        int16_t bx_right = apply_perspective(WORLD_HALF_W, (uint8_t)zi_back) + centerX;
+    for (uint8_t y = 0; y <= PIT_DEPTH; y++) {
+        int16_t fy = GRID_Y(0, y);
+        int16_t by = GRID_Y(back, y);
 
         // Top/Bottom walls (depth lines)
-        draw_line2buffer(GREEN, fx_left, fy, bx_left, by, buf);
-        draw_line2buffer(GREEN, fx_right, fy, bx_right, by, buf);
+        dl_line(GREEN, fx_left, fy, bx_left, by);
+        dl_line(GREEN, fx_right, fy, bx_right, by);
 
-        draw_line2buffer(GREEN, bx_left, by, bx_right, by, buf);
+        dl_line(GREEN, bx_left, by, bx_right, by);
     }
+}
 
+void draw_pit_background(void) {
+    for (uint8_t i = 0; i <= PIT_HEIGHT; i++) {
+        draw_pit_ring(i);
+    }
+    draw_pit_walls();
 }
 
 void draw_level_color_indicator(uint16_t buf) {
-    draw_vline2buffer(GREEN, 4, LEVEL_INDICATOR_HEIGHT - 3, PIT_HEIGHT * LEVEL_INDICATOR_WIDTH, buf);
-    draw_vline2buffer(GREEN, 5+LEVEL_INDICATOR_WIDTH, LEVEL_INDICATOR_HEIGHT - 3, PIT_HEIGHT * LEVEL_INDICATOR_WIDTH, buf);
+    uint8_t step = level_indicator_step;
+
+    draw_vline2buffer(GREEN, 4, LEVEL_INDICATOR_HEIGHT - 3, PIT_HEIGHT * step, buf);
+    draw_vline2buffer(GREEN, 5+LEVEL_INDICATOR_WIDTH, LEVEL_INDICATOR_HEIGHT - 3, PIT_HEIGHT * step, buf);
 
     // Draw level color blocks
     for (uint8_t i = 0; i < PIT_HEIGHT; i++) {
-        uint8_t z_idx = (PIT_HEIGHT - 1) - i; 
-        
-        uint8_t y_bottom = ((PIT_HEIGHT - 1 - i) * LEVEL_INDICATOR_WIDTH) + LEVEL_INDICATOR_HEIGHT;
-        
-        bool level_has_blocks = false;
-        for (uint8_t y = 0; y < PIT_DEPTH && !level_has_blocks; y++) {
-            for (uint8_t x = 0; x < PIT_WIDTH; x++) {
-                if (pit[z_idx][y][x]) {
-                    level_has_blocks = true;
-                    break;
-                }
-            }
-        }
-        
-        if (level_has_blocks) {
-            fill_rect2buffer(layer_colors[z_idx], 6, y_bottom - 3, LEVEL_INDICATOR_WIDTH-2, LEVEL_INDICATOR_WIDTH, buf);
+        uint8_t z_idx = (PIT_HEIGHT - 1) - i;
+
+        uint8_t y_bottom = ((PIT_HEIGHT - 1 - i) * step) + LEVEL_INDICATOR_HEIGHT;
+
+        if (!is_layer_empty(z_idx)) {
+            fill_rect2buffer(layer_colors[z_idx], 6, y_bottom - 3, LEVEL_INDICATOR_WIDTH-2, step, buf);
         } else {
             draw_pixel2buffer(GREEN, 5, y_bottom - 3, buf);
             draw_pixel2buffer(GREEN, LEVEL_INDICATOR_WIDTH + 4, y_bottom - 3, buf);
@@ -106,10 +99,10 @@ void draw_level_color_indicator(uint16_t buf) {
 
 /* ================= DRAW ================= */
 
+#define SHADOW_COLOR LIGHT_GRAY
 
-static uint8_t cache_px[MAX_BLOCKS * 8];
-static uint8_t cache_py[MAX_BLOCKS * 8];
-static bool cache_valid[MAX_BLOCKS * 8];
+static uint8_t cache_px[MAX_VERTICES];
+static uint8_t cache_py[MAX_VERTICES];
 static int16_t vert_off_x[8];
 static int16_t vert_off_y[8];
 static int16_t vert_off_z[8];
@@ -122,15 +115,65 @@ static inline uint8_t clamp_u8(int16_t value, uint8_t max_value) {
     return (uint8_t)value;
 }
 
+static inline bool footprint_has(const int8_t *fx, const int8_t *fy, const int8_t *fz, uint8_t n,
+                                 int8_t x, int8_t y, int8_t z) {
+    for (uint8_t b = 0; b < n; b++) {
+        if (fx[b] == x && fy[b] == y && fz[b] == z) return true;
+    }
+    return false;
+}
+
+// Outline the top face of every block where the piece would come to rest.
+// Corners come straight from the cached grid projection; edges shared by
+// two blocks on the same layer are drawn once by leaving them out entirely.
+static void draw_landing_shadow(uint16_t buffer) {
+    const Shape *s = &shapes[current_shape_idx];
+    int8_t fx[MAX_BLOCKS], fy[MAX_BLOCKS], fz[MAX_BLOCKS];
+    int8_t land = landing_z(shape_orient, shape_pos_x, shape_pos_y, shape_pos_z);
+    uint8_t n = s->num_blocks;
+
+    for (uint8_t b = 0; b < n; b++) {
+        int8_t rx, ry, rz;
+        get_rotated_offset(b, shape_orient, &rx, &ry, &rz);
+        fx[b] = shape_pos_x + rx;
+        fy[b] = shape_pos_y + ry;
+        fz[b] = land + rz;
+    }
+
+    for (uint8_t b = 0; b < n; b++) {
+        int8_t x = fx[b], y = fy[b], z = fz[b];
+        uint8_t x0 = clamp_u8(grid_sx[z][x], (uint8_t)(VIEWPORT_WIDTH - 1));
+        uint8_t x1 = clamp_u8(grid_sx[z][x + 1], (uint8_t)(VIEWPORT_WIDTH - 1));
+        uint8_t y0 = clamp_u8(grid_sy[z][y], (uint8_t)(VIEWPORT_HEIGHT - 1));
+        uint8_t y1 = clamp_u8(grid_sy[z][y + 1], (uint8_t)(VIEWPORT_HEIGHT - 1));
+
+        if (!footprint_has(fx, fy, fz, n, x, y - 1, z)) draw_line2buffer_small(SHADOW_COLOR, x0, y0, x1, y0, buffer);
+        if (!footprint_has(fx, fy, fz, n, x + 1, y, z)) draw_line2buffer_small(SHADOW_COLOR, x1, y0, x1, y1, buffer);
+        if (!footprint_has(fx, fy, fz, n, x, y + 1, z)) draw_line2buffer_small(SHADOW_COLOR, x0, y1, x1, y1, buffer);
+        if (!footprint_has(fx, fy, fz, n, x - 1, y, z)) draw_line2buffer_small(SHADOW_COLOR, x0, y0, x0, y1, buffer);
+    }
+}
+
 void drawShape(uint16_t buffer) {
     if (state.current == STATE_GAME_OVER) return;
 
     const Shape *s = &shapes[current_shape_idx];
     uint8_t b, i, e;
 
-    if (angleX != last_ax || angleY != last_ay || angleZ != last_az ||
+    if (shadow_enabled) {
+        draw_landing_shadow(buffer);
+    }
+
+    // At rest the angles are the canonical triple of shape_orient, so the
+    // index alone keys the cache; only a turn in progress compares angles.
+    bool turning = (state.current == STATE_ANIMATING);
+    uint8_t orient_key = turning ? 255 : shape_orient;
+
+    if (orient_key != last_orient ||
+        (turning && (angleX != last_ax || angleY != last_ay || angleZ != last_az)) ||
         last_shape != current_shape_idx || last_zoom != zoom_level) {
         
+        last_orient = orient_key;
         last_ax = angleX; last_ay = angleY; last_az = angleZ;
         last_shape = current_shape_idx;
         last_zoom = zoom_level;
@@ -149,64 +192,62 @@ void drawShape(uint16_t buffer) {
             vert_off_x[i] = (rot_ref_v[i][0] * CUBE_SIZE) / UNIT_SCALE;
             vert_off_y[i] = (rot_ref_v[i][1] * CUBE_SIZE) / UNIT_SCALE;
             vert_off_z[i] = (rot_ref_v[i][2] * CUBE_SIZE) / UNIT_SCALE;
-            vert_z_scale[i] = (vert_off_z[i] * PIT_Z_STEP) / GRID_SIZE;
-        }
-        for (b = 0; b < s->num_blocks; b++) {
-            block_z_scale[b] = (block_centers[b][2] * PIT_Z_STEP) / GRID_SIZE;
         }
-    }
-
-    int16_t base_world_x = (shape_pos_x * GRID_SIZE) + (GRID_SIZE / 2) - (VIEWPORT_WIDTH / 2) + ((s->center[0] * GRID_SIZE) / 2);
-    int16_t base_world_y = (shape_pos_y * GRID_SIZE) + (GRID_SIZE / 2) - (VIEWPORT_HEIGHT / 2) + ((s->center[1] * GRID_SIZE) / 2);
-    uint16_t base_zi = PIT_Z_START + (shape_pos_z * PIT_Z_STEP) + (PIT_Z_STEP / 2) + ((s->center[2] * PIT_Z_STEP) / 2);
-
-    for (i = 0; i < s->num_blocks * 8; i++) cache_valid[i] = false;
-
-    for (b = 0; b < s->num_blocks; b++) {
-        uint16_t mask = s->edge_masks[b];
-        int16_t b_off_x = block_centers[b][0];
-        int16_t b_off_y = block_centers[b][1];
-        int16_t b_off_z = block_centers[b][2];
-
-        for (e = 0; e < 12; e++) {
-            if (mask & (1 << e)) continue; // Skip internal edges
-            uint8_t v0 = edges[e << 1];
-            uint8_t v1 = edges[(e << 1) + 1];
-            uint8_t c0 = (b << 3) + v0;
-            uint8_t c1 = (b << 3) + v1;
-            uint8_t sx0, sy0, sx1, sy1;
-
-            if (!cache_valid[c0]) {
-                int16_t world_x = base_world_x + b_off_x + vert_off_x[v0];
-                int16_t world_y = base_world_y + b_off_y + vert_off_y[v0];
-                int16_t zi = base_zi + block_z_scale[b] + vert_z_scale[v0];
-                if (zi < 1) zi = 1; if (zi > 255) zi = 255;
-                int16_t screen_x = apply_perspective(world_x, (uint8_t)zi) + (VIEWPORT_WIDTH >> 1);
-                int16_t screen_y = apply_perspective(world_y, (uint8_t)zi) + (VIEWPORT_HEIGHT >> 1);
-                cache_px[c0] = clamp_u8(screen_x, (uint8_t)(VIEWPORT_WIDTH - 1));
-                cache_py[c0] = clamp_u8(screen_y, (uint8_t)(VIEWPORT_HEIGHT - 1));
-                cache_valid[c0] = true;
+        // The oblique view works in world units and needs no depth scale.
+        // Depth follows the zoom's layer spacing, z_step_fp.
+        if (perspective_enabled) {
+            int32_t unit = (int32_t)grid_size << 8;
+            for (i = 0; i < 8; i++) {
+                vert_z_scale[i] = ((int32_t)vert_off_z[i] * z_step_fp) / unit;
             }
-            sx0 = cache_px[c0];
-            sy0 = cache_py[c0];
-
-            if (!cache_valid[c1]) {
-                int16_t world_x = base_world_x + b_off_x + vert_off_x[v1];
-                int16_t world_y = base_world_y + b_off_y + vert_off_y[v1];
-                int16_t zi = base_zi + block_z_scale[b] + vert_z_scale[v1];
-                if (zi < 1) zi = 1; if (zi > 255) zi = 255;
-                int16_t screen_x = apply_perspective(world_x, (uint8_t)zi) + (VIEWPORT_WIDTH >> 1);
-                int16_t screen_y = apply_perspective(world_y, (uint8_t)zi) + (VIEWPORT_HEIGHT >> 1);
-                cache_px[c1] = clamp_u8(screen_x, (uint8_t)(VIEWPORT_WIDTH - 1));
-                cache_py[c1] = clamp_u8(screen_y, (uint8_t)(VIEWPORT_HEIGHT - 1));
-                cache_valid[c1] = true;
+            for (b = 0; b < s->num_blocks; b++) {
+                block_z_scale[b] = ((int32_t)block_centers[b][2] * z_step_fp) / unit;
             }
-            sx1 = cache_px[c1];
-            sy1 = cache_py[c1];
+        }
+    }
 
-            // draw_line2buffer(WHITE, sx0, sy0, sx1, sy1, buffer);
-            draw_line2buffer_small(WHITE, sx0, sy0, sx1, sy1, buffer);
+    int16_t base_world_x = (shape_pos_x * grid_size) + (grid_size / 2) + pit_origin_x + ((s->center[0] * grid_size) / 2);
+    int16_t base_world_y = (shape_pos_y * grid_size) + (grid_size / 2) + pit_origin_y + ((s->center[1] * grid_size) / 2);
+
+    // Each unique corner is projected once, through the block it was
+    // compiled from, then every outline edge is drawn once.
+    if (!perspective_enabled) {
+        int16_t base_world_z = (shape_pos_z * grid_size) + (grid_size / 2) + ((s->center[2] * grid_size) / 2);
+        base_world_x += SCREEN_CENTER_X;
+        base_world_y += SCREEN_CENTER_Y;
+        for (i = 0; i < s->num_vertices; i++) {
+            uint8_t bv = s->vertices[i];
+            b = bv >> 3;
+            uint8_t v = bv & 7;
+            int16_t shift = oblique_shift(base_world_z + block_centers[b][2] + vert_off_z[v]);
+            int16_t screen_x = base_world_x + block_centers[b][0] + vert_off_x[v] + shift;
+            int16_t screen_y = base_world_y + block_centers[b][1] + vert_off_y[v] + shift;
+            cache_px[i] = clamp_u8(screen_x, (uint8_t)(VIEWPORT_WIDTH - 1));
+            cache_py[i] = clamp_u8(screen_y, (uint8_t)(VIEWPORT_HEIGHT - 1));
         }
+    } else {
+        // Block centre depth in half layers: shape_pos_z + 1/2 + center / 2
+        uint16_t half_layers = (shape_pos_z * 2) + 1 + s->center[2];
+        uint16_t base_zi = PIT_Z_START + (uint16_t)(((uint32_t)half_layers * z_step_fp) >> 9);
+        for (i = 0; i < s->num_vertices; i++) {
+            uint8_t bv = s->vertices[i];
+            b = bv >> 3;
+            uint8_t v = bv & 7;
+            int16_t world_x = base_world_x + block_centers[b][0] + vert_off_x[v];
+            int16_t world_y = base_world_y + block_centers[b][1] + vert_off_y[v];
+            int16_t zi = base_zi + block_z_scale[b] + vert_z_scale[v];
+            if (zi < 1) zi = 1; if (zi > 255) zi = 255;
+            int16_t screen_x = apply_perspective_fast(world_x, (uint8_t)zi) + (VIEWPORT_WIDTH >> 1);
+            int16_t screen_y = apply_perspective_fast(world_y, (uint8_t)zi) + (VIEWPORT_HEIGHT >> 1);
+            cache_px[i] = clamp_u8(screen_x, (uint8_t)(VIEWPORT_WIDTH - 1));
+            cache_py[i] = clamp_u8(screen_y, (uint8_t)(VIEWPORT_HEIGHT - 1));
+        }
+    }
+
+    for (e = 0; e < s->num_edges; e++) {
+        uint8_t v0 = s->edges[e][0];
+        uint8_t v1 = s->edges[e][1];
+        draw_line2buffer_small(WHITE, cache_px[v0], cache_py[v0], cache_px[v1], cache_py[v1], buffer);
     }
 }
 
@@ -233,198 +274,193 @@ void draw_shape_position(){
 
 }
 
-static uint8_t left_edges[SCREEN_HEIGHT];
-static uint8_t right_edges[SCREEN_HEIGHT];
-
-void draw_poly_fast(uint16_t buf, int16_t x0, int16_t y0, int16_t x1, int16_t y1, 
-                    int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint8_t color, uint8_t stride) {
-    uint8_t min_y = SCREEN_HEIGHT, max_y = 0;
-    int16_t px[5], py[5];
-    px[0]=x0; px[1]=x1; px[2]=x2; px[3]=x3; px[4]=x0;
-    py[0]=y0; py[1]=y1; py[2]=y2; py[3]=y3; py[4]=y0;
-
-    for(uint8_t i=0; i<4; i++) {
-        if (py[i] < 0) py[i] = 0; if (py[i] > 179) py[i] = 179;
-        if (px[i] < 0) px[i] = 0; if (px[i] > 255) px[i] = 255; // Clamp X to 8-bit
-        if ((uint8_t)py[i] < min_y) min_y = (uint8_t)py[i];
-        if ((uint8_t)py[i] > max_y) max_y = (uint8_t)py[i];
+/* ================= FILL QUALITY ================= */
+
+// Static fills run at every row, or at every other screen row while the
+// frame budget is tight. Reduced fills always take the even rows, and a
+// refinement pass later repaints the settled layers back to front on the
+// odd rows alone. Each row is then painted in full painter's order in one
+// of the two passes, so the result matches a full-density redraw.
+uint8_t fill_stride = 1;
+static uint8_t fill_phase = 0;        // Row parity being drawn when stride is 2
+static uint8_t quality_slack = 0;     // Passes in a row that kept to one vsync
+static bool refine_pending = false;
+static uint8_t refine_z;              // Layers still to refine, from the back
+
+// A reduced draw leaves odd rows behind; restart the refinement so it
+// repaints every layer after it.
+static inline void note_reduced_fill(void) {
+    if (fill_stride > 1 && !fill_phase) {
+        refine_pending = true;
+        refine_z = PIT_HEIGHT;
     }
+}
 
-    for (uint8_t i = min_y; i <= max_y; i++) {
-        left_edges[i] = 255; right_edges[i] = 0;
+void quality_update(uint8_t vsyncs, bool busy) {
+    if (vsyncs > 1) {
+        fill_stride = 2;
+        quality_slack = 0;
+        return;
     }
-
-    for (uint8_t i = 0; i < 4; i++) {
-        int16_t x_s = px[i], y_s = py[i], x_e = px[i+1], y_e = py[i+1];
-        if (y_s == y_e) continue;
-        if (y_s > y_e) { int16_t t; t=x_s; x_s=x_e; x_e=t; t=y_s; y_s=y_e; y_e=t; }
-
-        uint16_t dx = (x_e >= x_s) ? (x_e - x_s) : (x_s - x_e);
-        uint16_t dy = y_e - y_s;
-        int16_t sx = (x_e >= x_s) ? 1 : -1;
-        int16_t err = dy >> 1;
-        int16_t cur_x = x_s;
-
-        for (uint8_t y = (uint8_t)y_s; y <= (uint8_t)y_e; y++) {
-            if (y < 180) {
-                if ((uint8_t)cur_x < left_edges[y]) left_edges[y] = (uint8_t)cur_x;
-                if ((uint8_t)cur_x > right_edges[y]) right_edges[y] = (uint8_t)cur_x;
-            }
-            err += dx;
-            while (err >= (int16_t)dy) { err -= dy; cur_x += sx; }
+    if (quality_slack < QUALITY_SLACK_FRAMES) {
+        quality_slack++;
+        return;
+    }
+    if (busy) return;
+    if (refine_pending) {
+        // One layer per pass, so the pass itself stays inside the frame.
+        // A resize since the reduced draw may have left fewer layers.
+        if (refine_z > PIT_HEIGHT) refine_z = PIT_HEIGHT;
+        while (refine_z > 0 && is_layer_empty(refine_z - 1)) refine_z--;
+        if (refine_z > 0) {
+            fill_phase = 1;
+            draw_settled_layer(--refine_z);
+            dl_flush();
+            fill_phase = 0;
         }
+        if (refine_z > 0) return;
+        refine_pending = false;
     }
+    fill_stride = 1;
+}
 
-    for (uint8_t y = min_y; y <= max_y; y += stride) {
-        if (left_edges[y] <= right_edges[y]) 
-            draw_line2buffer(color, left_edges[y], y, right_edges[y], y, buf);
-    }
+// Top faces are upright rectangles in both views, queued with the same
+// row split as the sides. Without fill only the outline goes down again.
+static void draw_top_face(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                          uint8_t color, bool fill) {
+    if (fill) dl_rect(color, x0, y0, x1, y1, fill_stride, fill_phase);
+    dl_frame(BLACK, x0, y0, x1, y1, fill_stride, fill_phase);
+}
+
+void draw_poly_fast(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                    int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint8_t color, uint8_t stride) {
+    dl_quad(color, x0, y0, x1, y1, x2, y2, x3, y3, stride, fill_phase);
 }
 
-void draw_cube_at(uint16_t buf, uint8_t x, uint8_t y, uint8_t z, uint8_t color) {
+void draw_cube_at(uint8_t x, uint8_t y, uint8_t z, uint8_t color) {
     // 1. Calculate visibility flags FIRST
-    bool draw_top   = (z == 0) || !pit[z-1][y][x];
-    bool draw_left  = (x == 0) || !pit[z][y][x-1];
-    bool draw_right = (x == PIT_WIDTH - 1) || !pit[z][y][x+1];
-    bool draw_back  = (y == PIT_DEPTH - 1) || !pit[z][y+1][x];
-    bool draw_front = (y == 0) || !pit[z][y-1][x]; // Added for completeness/correctness
+    bool draw_top   = (z == 0) || !pit_cell(x, y, z-1);
+    bool draw_left  = (x == 0) || !pit_cell(x-1, y, z);
+    bool draw_right = (x == PIT_WIDTH - 1) || !pit_cell(x+1, y, z);
+    bool draw_back  = (y == PIT_DEPTH - 1) || !pit_cell(x, y+1, z);
+    bool draw_front = (y == 0) || !pit_cell(x, y-1, z); // Added for completeness/correctness
+
+    // The oblique view shifts deeper layers down-right, which hides the
+    // left and front faces under the top
+    if (!perspective_enabled) draw_left = draw_front = false;
 
     // 2. Optimization: If no faces are visible, return immediately
     if (!draw_top && !draw_left && !draw_right && !draw_back && !draw_front) return;
 
+    note_reduced_fill();
+
     // 3. Draw all visible faces
     if (draw_top) {
-        draw_poly_fast(buf, 
-            grid_sx[z][y][x],     grid_sy[z][y],
-            grid_sx[z][y][x+1],   grid_sy[z][y],
-            grid_sx[z][y+1][x+1], grid_sy[z][y+1],
-            grid_sx[z][y+1][x],   grid_sy[z][y+1],
-            color, FILL_STRIDE);
-        
-        // Top face outline
-        draw_line2buffer(BLACK, grid_sx[z][y][x], grid_sy[z][y], 
-                        grid_sx[z][y][x+1], grid_sy[z][y], buf);
-        draw_line2buffer(BLACK, grid_sx[z][y][x+1], grid_sy[z][y], 
-                        grid_sx[z][y+1][x+1], grid_sy[z][y+1], buf);
-        draw_line2buffer(BLACK, grid_sx[z][y+1][x+1], grid_sy[z][y+1], 
-                        grid_sx[z][y+1][x], grid_sy[z][y+1], buf);
-        draw_line2buffer(BLACK, grid_sx[z][y+1][x], grid_sy[z][y+1], 
-                        grid_sx[z][y][x], grid_sy[z][y], buf);
+        draw_top_face(GRID_X(z, x), GRID_Y(z, y), GRID_X(z, x+1), GRID_Y(z, y+1), color, true);
     }
 
     if (draw_left) {
-        draw_poly_fast(buf,
-            grid_sx[z][y][x],     grid_sy[z][y],
-            grid_sx[z+1][y][x],   grid_sy[z+1][y],
-            grid_sx[z+1][y+1][x], grid_sy[z+1][y+1],
-            grid_sx[z][y+1][x],   grid_sy[z][y+1],
-            color, FILL_STRIDE);
+        draw_poly_fast(
+            GRID_X(z, x),     GRID_Y(z, y),
+            GRID_X(z+1, x),   GRID_Y(z+1, y),
+            GRID_X(z+1, x), GRID_Y(z+1, y+1),
+            GRID_X(z, x),   GRID_Y(z, y+1),
+            color, fill_stride);
     }
 
     if (draw_right) {
-        draw_poly_fast(buf,
-            grid_sx[z][y][x+1],     grid_sy[z][y],
-            grid_sx[z+1][y][x+1],   grid_sy[z+1][y],
-            grid_sx[z+1][y+1][x+1], grid_sy[z+1][y+1],
-            grid_sx[z][y+1][x+1],   grid_sy[z][y+1],
-            color, FILL_STRIDE);
+        draw_poly_fast(
+            GRID_X(z, x+1),     GRID_Y(z, y),
+            GRID_X(z+1, x+1),   GRID_Y(z+1, y),
+            GRID_X(z+1, x+1), GRID_Y(z+1, y+1),
+            GRID_X(z, x+1),   GRID_Y(z, y+1),
+            color, fill_stride);
     }
 
     if (draw_back) {
-        draw_poly_fast(buf,
-            grid_sx[z][y+1][x],     grid_sy[z][y+1],
-            grid_sx[z][y+1][x+1],   grid_sy[z][y+1],
-            grid_sx[z+1][y+1][x+1], grid_sy[z+1][y+1],
-            grid_sx[z+1][y+1][x],   grid_sy[z+1][y+1],
-            color, FILL_STRIDE);
+        draw_poly_fast(
+            GRID_X(z, x),     GRID_Y(z, y+1),
+            GRID_X(z, x+1),   GRID_Y(z, y+1),
+            GRID_X(z+1, x+1), GRID_Y(z+1, y+1),
+            GRID_X(z+1, x),   GRID_Y(z+1, y+1),
+            color, fill_stride);
     }
 
     if (draw_front) {
-        draw_poly_fast(buf,
-            grid_sx[z][y][x],     grid_sy[z][y],
-            grid_sx[z][y][x+1],   grid_sy[z][y],
-            grid_sx[z+1][y][x+1], grid_sy[z+1][y],
-            grid_sx[z+1][y][x],   grid_sy[z+1][y],
-            color, FILL_STRIDE);
+        draw_poly_fast(
+            GRID_X(z, x),     GRID_Y(z, y),
+            GRID_X(z, x+1),   GRID_Y(z, y),
+            GRID_X(z+1, x+1), GRID_Y(z+1, y),
+            GRID_X(z+1, x),   GRID_Y(z+1, y),
+            color, fill_stride);
     }
-    
-    
+
+    // Sides can cross the outline where they meet the top
     if (draw_top) {
-        draw_line2buffer(BLACK, grid_sx[z][y][x], grid_sy[z][y], 
-                        grid_sx[z][y][x+1], grid_sy[z][y], buf);
-        draw_line2buffer(BLACK, grid_sx[z][y][x+1], grid_sy[z][y], 
-                        grid_sx[z][y+1][x+1], grid_sy[z][y+1], buf);
-        draw_line2buffer(BLACK, grid_sx[z][y+1][x+1], grid_sy[z][y+1], 
-                        grid_sx[z][y+1][x], grid_sy[z][y+1], buf);
-        draw_line2buffer(BLACK, grid_sx[z][y+1][x], grid_sy[z][y+1], 
-                        grid_sx[z][y][x], grid_sy[z][y], buf);
+        draw_top_face(GRID_X(z, x), GRID_Y(z, y), GRID_X(z, x+1), GRID_Y(z, y+1), color, false);
     }
 }
 
 
-void draw_settled_range(uint16_t buffer, uint8_t start_z) {
-    for (int8_t z = PIT_HEIGHT - 1; z >= start_z; z--) {
-        for (uint8_t y = 0; y < PIT_DEPTH; y++) {
-            for (uint8_t x = 0; x < PIT_WIDTH; x++) {
-                if (pit[z][y][x]) {
-                    draw_cube_at(buffer, x, y, z, layer_colors[z]);
-                }
-            }
-        }
+void draw_settled_blocks(void) {
+    // Painter's algorithm: BACK TO FRONT
+    // In perspective: higher Z = further back, higher Y = further back.
+    // In the oblique view faces only reach down-right, which this order
+    // also paints over correctly. Each layer is flushed on its own.
+    for (int8_t z = PIT_HEIGHT - 1; z >= 0; z--) {
+        draw_settled_layer(z);
+        dl_flush();
     }
 }
 
-void draw_settled_blocks(uint16_t buf) {
-    // Painter's algorithm: BACK TO FRONT
-    // In perspective: higher Z = further back, higher Y = further back
-    for (int8_t z = PIT_HEIGHT - 1; z >= 0; z--) {
-        for (uint8_t y = 0; y < PIT_DEPTH; y++) {  
-            for (uint8_t x = 0; x < PIT_WIDTH; x++) {
-                if (!pit[z][y][x]) continue; 
-                
-                uint8_t color = layer_colors[z];
-                
-                // Front Face (Index z)
-                int16_t fx0 = grid_sx[z][y][x];     int16_t fy0 = grid_sy[z][y];
-                int16_t fx1 = grid_sx[z][y][x+1];   int16_t fy1 = grid_sy[z][y];
-                int16_t fx3 = grid_sx[z][y+1][x];   int16_t fy3 = grid_sy[z][y+1];
-                int16_t fx2 = grid_sx[z][y+1][x+1]; int16_t fy2 = grid_sy[z][y+1];
-                
-                // Back Face (Index z+1)
-                int16_t bx0 = grid_sx[z+1][y][x];   int16_t by0 = grid_sy[z+1][y];
-                int16_t bx1 = grid_sx[z+1][y][x+1]; int16_t by1 = grid_sy[z+1][y];
-                int16_t bx3 = grid_sx[z+1][y+1][x]; int16_t by3 = grid_sy[z+1][y+1];
-                int16_t bx2 = grid_sx[z+1][y+1][x+1]; int16_t by2 = grid_sy[z+1][y+1];
-
-                // Simplified visibility: only draw faces at edges or with empty neighbors
-                bool draw_left  = (x == 0) || !pit[z][y][x-1];
-                bool draw_right = (x == PIT_WIDTH - 1) || !pit[z][y][x+1];
-                bool draw_back  = (y == PIT_DEPTH - 1) || !pit[z][y+1][x];
-                bool draw_front = (y == 0) || !pit[z][y-1][x];
-                bool draw_top   = (z == 0) || !pit[z-1][y][x];
-
-                // Draw faces
-                if (draw_left) 
-                    draw_poly_fast(buf, fx0, fy0, fx3, fy3, bx3, by3, bx0, by0, color, FILL_STRIDE);
-                
-                if (draw_right) 
-                    draw_poly_fast(buf, fx1, fy1, bx1, by1, bx2, by2, fx2, fy2, color, FILL_STRIDE);
-                
-                if (draw_front) 
-                    draw_poly_fast(buf, fx0, fy0, bx0, by0, bx1, by1, fx1, fy1, color, FILL_STRIDE);
-                
-                if (draw_back) 
-                    draw_poly_fast(buf, fx3, fy3, fx2, fy2, bx2, by2, bx3, by3, color, FILL_STRIDE);
-                
-                if (draw_top) {
-                    draw_poly_fast(buf, fx0, fy0, fx1, fy1, fx2, fy2, fx3, fy3, color, FILL_STRIDE);
-                    
-                    draw_line2buffer(BLACK, fx0, fy0, fx1, fy1, buf);
-                    draw_line2buffer(BLACK, fx1, fy1, fx2, fy2, buf);
-                    draw_line2buffer(BLACK, fx2, fy2, fx3, fy3, buf);
-                    draw_line2buffer(BLACK, fx3, fy3, fx0, fy0, buf);
-                } 
-            }
+// One layer of settled cubes. Empty rows are skipped a byte at a time,
+// so the cost follows the number of settled cubes rather than the size
+// of the pit.
+void draw_settled_layer(uint8_t z) {
+    note_reduced_fill();
+    for (uint8_t y = 0; y < PIT_DEPTH; y++) {  
+        uint8_t row = pit_rows[z][y];
+        if (!row) continue;
+        for (uint8_t x = 0; x < PIT_WIDTH; x++) {
+            if (!(row & pit_bit[x])) continue; 
+            
+            uint8_t color = layer_colors[z];
+            
+            // Front Face (Index z)
+            int16_t fx0 = GRID_X(z, x);     int16_t fy0 = GRID_Y(z, y);
+            int16_t fx1 = GRID_X(z, x+1);   int16_t fy1 = GRID_Y(z, y);
+            int16_t fx3 = GRID_X(z, x);   int16_t fy3 = GRID_Y(z, y+1);
+            int16_t fx2 = GRID_X(z, x+1); int16_t fy2 = GRID_Y(z, y+1);
+            
+            // Back Face (Index z+1)
+            int16_t bx0 = GRID_X(z+1, x);   int16_t by0 = GRID_Y(z+1, y);
+            int16_t bx1 = GRID_X(z+1, x+1); int16_t by1 = GRID_Y(z+1, y);
+            int16_t bx3 = GRID_X(z+1, x); int16_t by3 = GRID_Y(z+1, y+1);
+            int16_t bx2 = GRID_X(z+1, x+1); int16_t by2 = GRID_Y(z+1, y+1);
+
+            // Simplified visibility: only draw faces at edges or with empty neighbors
+            bool draw_left  = (x == 0) || !pit_cell(x-1, y, z);
+            bool draw_right = (x == PIT_WIDTH - 1) || !pit_cell(x+1, y, z);
+            bool draw_back  = (y == PIT_DEPTH - 1) || !pit_cell(x, y+1, z);
+            bool draw_front = (y == 0) || !pit_cell(x, y-1, z);
+            bool draw_top   = (z == 0) || !pit_cell(x, y, z-1);
+            if (!perspective_enabled) draw_left = draw_front = false;
+
+            // Draw faces
+            if (draw_left) 
+                draw_poly_fast(fx0, fy0, fx3, fy3, bx3, by3, bx0, by0, color, fill_stride);
+            
+            if (draw_right) 
+                draw_poly_fast(fx1, fy1, bx1, by1, bx2, by2, fx2, fy2, color, fill_stride);
+            
+            if (draw_front) 
+                draw_poly_fast(fx0, fy0, bx0, by0, bx1, by1, fx1, fy1, color, fill_stride);
+            
+            if (draw_back) 
+                draw_poly_fast(fx3, fy3, fx2, fy2, bx2, by2, bx3, by3, color, fill_stride);
+            
+            if (draw_top)
+                draw_top_face(fx0, fy0, fx2, fy2, color, true);
         }
     }
 }
@@ -434,11 +470,12 @@ void draw_incremental_lock(int8_t min_x, int8_t max_x, int8_t min_y, int8_t max_
     for (int8_t z = start_z; z >= 0; z--) {
         for (int8_t y = max_y; y >= min_y; y--) {
             for (int8_t x = min_x; x <= max_x; x++) {
-                if (pit[z][y][x]) {
-                    draw_cube_at(STATIC_BUFFER_ADDR, x, y, z, layer_colors[z]);
+                if (pit_cell(x, y, z)) {
+                    draw_cube_at(x, y, z, layer_colors[z]);
                 }
             }
         }
+        dl_flush();
     }
 }
 
@@ -11,7 +11,22 @@
 
 
 
-void draw_pit_background(uint16_t buf);
+// Pit, face and outline drawing on the static plane is queued on the
+// display list (blockout_dlist.h) and reaches XRAM at dl_flush().
+// draw_settled_blocks() and draw_incremental_lock() flush each layer.
+
+// Fill density for the static plane: 1 = every row, 2 = every other row
+extern uint8_t fill_stride;
+
+// Governor, once per main loop pass: an overrun of the last pass halves
+// the fills, and after enough passes on time the skipped rows are drawn
+// a layer per pass. busy holds the refinement while the static plane is
+// being rebuilt or shows something other than the pit.
+void quality_update(uint8_t vsyncs, bool busy);
+
+void draw_pit_ring(uint8_t z);
+void draw_pit_walls(void);
+void draw_pit_background(void);
 
 void draw_level_color_indicator(uint16_t buf);
 
@@ -19,16 +34,15 @@ void drawShape(uint16_t buffer);
 
 void draw_shape_position();
 
-void draw_poly_fast(uint16_t buf, int16_t x0, int16_t y0, int16_t x1, int16_t y1, 
+void draw_poly_fast(int16_t x0, int16_t y0, int16_t x1, int16_t y1, 
                     int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint8_t color, uint8_t stride);
 
-void draw_cube_at(uint16_t buf, uint8_t x, uint8_t y, uint8_t z, uint8_t color);
-
+void draw_cube_at(uint8_t x, uint8_t y, uint8_t z, uint8_t color);
 
 
-void draw_settled_range(uint16_t buffer, uint8_t start_z);
 
-void draw_settled_blocks(uint16_t buf);
+void draw_settled_blocks(void);
+void draw_settled_layer(uint8_t z);
 
 void draw_incremental_lock(int8_t min_x, int8_t max_x, int8_t min_y, int8_t max_y, int8_t start_z);
 
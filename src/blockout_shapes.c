@@ -8,6 +8,7 @@
 #include "blockout_shapes.h"
 #include "blockout_pit.h"
 #include "blockout_state.h"
+#include "blockout_random.h"
 
 /* ================= SHAPE POSITION ================= */
 
@@ -15,103 +16,24 @@ int8_t shape_pos_x;
 int8_t shape_pos_y;
 int8_t shape_pos_z;
 
-const Shape shapes[NUM_SHAPES] = {
-    // Cube: Center at 0
-    {1,"CUBE",{{0,0,0}}, {0}, {0,0,0}},
-    
-    // short I-Piece
-    {2,"I",{{0,0,0},{0,1,0}},
-        {MASK_FACE_TOP, MASK_FACE_BOTTOM}, 
-        {0,0,0}},
-
-    // I-Piece: Center on middle block
-    {3,"I",{{0,-1,0},{0,0,0},{0,1,0}},
-        {MASK_FACE_TOP, MASK_FACE_TOP|MASK_FACE_BOTTOM, MASK_FACE_BOTTOM}, 
-        {0,0,0}},
-
-    // big cube: MUST have center at (0.5, 0.5, 0) = {1, 1, 0} in half-blocks
-    {4, "C", {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}},
-        {MASK_FACE_RIGHT|MASK_FACE_TOP, MASK_FACE_TOP|MASK_FACE_LEFT, 
-         MASK_FACE_RIGHT|MASK_FACE_BOTTOM, MASK_FACE_BOTTOM|MASK_FACE_LEFT},
-        {1,1,1}},  // This is correct for a 2x2 cube
-    
-    // L-Piece: Center on middle block
-    {3,"L",{{0,-1,0},{0,0,0},{1,0,0}},
-        {MASK_FACE_TOP, MASK_FACE_BOTTOM|MASK_FACE_RIGHT, MASK_FACE_LEFT}, 
-        {0,0,0}},
-    
-    // T-Piece: Center at intersection
-    {4,"T",{{-1,0,0},{0,0,0},{1,0,0},{0,-1,0}},
-        {MASK_FACE_RIGHT, MASK_FACE_LEFT|MASK_FACE_RIGHT|MASK_FACE_BOTTOM,
-         MASK_FACE_LEFT, MASK_FACE_TOP}, 
-        {0,0,0}},
-    
-    // S-Piece
-    {4,"S",{{0,-1,0},{0,0,0},{1,0,0},{1,1,0}},
-        {MASK_FACE_TOP, MASK_FACE_BOTTOM|MASK_FACE_RIGHT,
-         MASK_FACE_LEFT|MASK_FACE_TOP, MASK_FACE_BOTTOM}, 
-        {2,0,0}},
-    
-    // L+-Piece: Center on middle block
-    {4,"L+",{{0,-1,0},{0,0,0},{1,0,0},{0,0,1}},
-        {MASK_FACE_TOP, MASK_FACE_BOTTOM|MASK_FACE_RIGHT|MASK_FACE_FRONT, MASK_FACE_LEFT, MASK_FACE_BACK}, 
-        {0,0,0}},
-};
+// The shape table is compiled from shapes/shapes.txt at build time;
+// BLOCKOUT_SHAPE_SET selects which set is built in.
+#include "shape_data.h"
 
-
-void get_rotated_offset(uint8_t block_idx, uint8_t use_angleX, uint8_t use_angleY, uint8_t use_angleZ, int8_t *rx, int8_t *ry, int8_t *rz) {
+void get_rotated_offset(uint8_t block_idx, uint8_t orient, int8_t *rx, int8_t *ry, int8_t *rz) {
     const Shape *s = &shapes[current_shape_idx];
-    
-    bool has_half_center = (s->center[0] != 0) || (s->center[1] != 0) || (s->center[2] != 0);
-    
-    if (!has_half_center) {
-        int16_t x = s->offsets[block_idx][0];
-        int16_t y = s->offsets[block_idx][1];
-        int16_t z = s->offsets[block_idx][2];
-        int16_t t;
-
-        uint8_t ay = (use_angleY >> 6) & 3;
-        for(uint8_t i=0; i<ay; i++) { t=x; x=z; z=-t; }
-        
-        uint8_t ax = (use_angleX >> 6) & 3;
-        for(uint8_t i=0; i<ax; i++) { t=y; y=-z; z=t; }
-        
-        uint8_t az = (use_angleZ >> 6) & 3;
-        for(uint8_t i=0; i<az; i++) { t=x; x=-y; y=t; }
-
-        *rx = (int8_t)x;
-        *ry = (int8_t)y;
-        *rz = (int8_t)z;
-    } else {
-        int16_t x = (int16_t)s->offsets[block_idx][0] * 2 - s->center[0];
-        int16_t y = (int16_t)s->offsets[block_idx][1] * 2 - s->center[1];
-        int16_t z = (int16_t)s->offsets[block_idx][2] * 2 - s->center[2];
-        int16_t t;
-
-        uint8_t ay = (use_angleY >> 6) & 3;
-        for(uint8_t i=0; i<ay; i++) { t=x; x=z; z=-t; }
-        
-        uint8_t ax = (use_angleX >> 6) & 3;
-        for(uint8_t i=0; i<ax; i++) { t=y; y=-z; z=t; }
-        
-        uint8_t az = (use_angleZ >> 6) & 3;
-        for(uint8_t i=0; i<az; i++) { t=x; x=-y; y=t; }
+    const int8_t *o = s->orient_offsets[orient * s->num_blocks + block_idx];
 
-        x += s->center[0];
-        y += s->center[1];
-        z += s->center[2];
-        
-        *rx = x / 2;
-        *ry = y / 2;
-        *rz = z / 2;
-    }
+    *rx = o[0];
+    *ry = o[1];
+    *rz = o[2];
 }
 
 bool is_position_valid(int8_t px, int8_t py, int8_t pz) {
     const Shape *s = &shapes[current_shape_idx];
     for (uint8_t b = 0; b < s->num_blocks; b++) {
         int8_t rx, ry, rz;
-        get_rotated_offset(b, angleX, angleY, angleZ, &rx, &ry, &rz);
+        get_rotated_offset(b, shape_orient, &rx, &ry, &rz);
         
         int8_t abs_x = px + rx;
         int8_t abs_y = py + ry;
@@ -120,16 +42,16 @@ bool is_position_valid(int8_t px, int8_t py, int8_t pz) {
         if (abs_x < 0 || abs_x >= PIT_WIDTH)  return false;
         if (abs_y < 0 || abs_y >= PIT_DEPTH)  return false;
         if (abs_z < 0 || abs_z >= PIT_HEIGHT) return false;
-        if (pit[abs_z][abs_y][abs_x]) return false;
+        if (pit_cell(abs_x, abs_y, abs_z)) return false;
     }
     return true;
 }
 
-bool is_rotation_valid_at(uint8_t nX, uint8_t nY, uint8_t nZ, int8_t px, int8_t py, int8_t pz) {
+bool is_rotation_valid_at(uint8_t orient, int8_t px, int8_t py, int8_t pz) {
     const Shape *s = &shapes[current_shape_idx];
     for (uint8_t b = 0; b < s->num_blocks; b++) {
         int8_t rx, ry, rz;
-        get_rotated_offset(b, nX, nY, nZ, &rx, &ry, &rz);
+        get_rotated_offset(b, orient, &rx, &ry, &rz);
         
         int8_t abs_x = px + rx;
         int8_t abs_y = py + ry;
@@ -138,19 +60,20 @@ bool is_rotation_valid_at(uint8_t nX, uint8_t nY, uint8_t nZ, int8_t px, int8_t
         if (abs_x < 0 || abs_x >= PIT_WIDTH)  return false;
         if (abs_y < 0 || abs_y >= PIT_DEPTH)  return false;
         if (abs_z < 0 || abs_z >= PIT_HEIGHT) return false;
-        if (pit[abs_z][abs_y][abs_x]) return false;
+        if (pit_cell(abs_x, abs_y, abs_z)) return false;
     }
     return true;
 }
 
-void apply_rotation(uint8_t new_angleX, uint8_t new_angleY, uint8_t new_angleZ) {
-    angleX = new_angleX;
-    angleY = new_angleY;
-    angleZ = new_angleZ;
+void apply_rotation(uint8_t orient) {
+    shape_orient = orient;
+    angleX = targetX = orient_angles[orient][0];
+    angleY = targetY = orient_angles[orient][1];
+    angleZ = targetZ = orient_angles[orient][2];
 }
 
-bool try_wall_kick(uint8_t nX, uint8_t nY, uint8_t nZ, int8_t *out_x, int8_t *out_y, int8_t *out_z) {
-    if (is_rotation_valid_at(nX, nY, nZ, shape_pos_x, shape_pos_y, shape_pos_z)) {
+bool try_wall_kick(uint8_t orient, int8_t *out_x, int8_t *out_y, int8_t *out_z) {
+    if (is_rotation_valid_at(orient, shape_pos_x, shape_pos_y, shape_pos_z)) {
         *out_x = shape_pos_x;
         *out_y = shape_pos_y;
         *out_z = shape_pos_z;
@@ -174,7 +97,7 @@ bool try_wall_kick(uint8_t nX, uint8_t nY, uint8_t nZ, int8_t *out_x, int8_t *ou
         int8_t test_y = shape_pos_y + kick_offsets[i][1];
         int8_t test_z = shape_pos_z + kick_offsets[i][2];
 
-        if (is_rotation_valid_at(nX, nY, nZ, test_x, test_y, test_z)) {
+        if (is_rotation_valid_at(orient, test_x, test_y, test_z)) {
             *out_x = test_x;
             *out_y = test_y;
             *out_z = test_z;
@@ -185,17 +108,32 @@ bool try_wall_kick(uint8_t nX, uint8_t nY, uint8_t nZ, int8_t *out_x, int8_t *ou
     return false;
 }
 
+bool begin_rotation(uint8_t orient, uint8_t tX, uint8_t tY, uint8_t tZ) {
+    int8_t kX, kY, kZ;
+    if (!try_wall_kick(orient, &kX, &kY, &kZ)) return false;
+
+    shape_pos_x = kX;
+    shape_pos_y = kY;
+    shape_pos_z = kZ;
+    shape_orient = orient;
+    // The animation turns towards (tX, tY, tZ) and snaps to the
+    // canonical angles of the orientation when it ends
+    targetX = tX;
+    targetY = tY;
+    targetZ = tZ;
+    change_state(STATE_ANIMATING);
+    return true;
+}
+
 void spawn_new_shape(void) {
     const Shape *s = &shapes[current_shape_idx];
     current_shape_idx = next_shape_idx;
-    srand(seed);
-    next_shape_idx = random(0, NUM_SHAPES);
+    next_shape_idx = bag_next();
     
     shape_pos_x = PIT_WIDTH / 2;
     shape_pos_y = PIT_DEPTH / 2;
     shape_pos_z = 0;
-    angleX = angleY = angleZ = 0;
-    targetX = targetY = targetZ = 0;
+    apply_rotation(0);
     state.anim_counter = 0;
     
     if (!is_position_valid(shape_pos_x, shape_pos_y, shape_pos_z)) {
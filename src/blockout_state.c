@@ -29,8 +29,9 @@ void change_state(GameState new_state) {
     if (new_state == STATE_GAME_OVER || state.previous == STATE_GAME_OVER) {
         mark_hud_dirty();
     }
+    // Leaving game over only takes the banner down; the start screen hides
+    // the pit and reset_game_state() redraws it before the next game
     if (state.previous == STATE_GAME_OVER && new_state != STATE_GAME_OVER) {
-        state.full_redraw_pending = true;
         state.need_static_redraw = true;
     }
     
@@ -45,8 +46,9 @@ void change_state(GameState new_state) {
             break;
             
         case STATE_FAST_DROP:
+        case STATE_HARD_DROP:
             state.drop_timer = 0;
-            play_drop_sound(); 
+            post_sound(SOUND_DROP);
             break;
             
         case STATE_PLAYING:
@@ -56,10 +58,12 @@ void change_state(GameState new_state) {
         case STATE_GAME_OVER:
             state.need_static_redraw = true;
             trigger_game_over_shake();
-            start_game_over_sound();
+            stop_music();
+            post_sound(SOUND_GAME_OVER);
             break;
 
         case STATE_START_SCREEN:
+            stop_music();
             score = 0;
             cubes_played = 0;
             mark_hud_dirty();
@@ -105,7 +109,7 @@ void handle_animating_state(void) {
     
     state.anim_counter--;
     if (state.anim_counter == 0) {
-        apply_rotation(targetX, targetY, targetZ);
+        apply_rotation(shape_orient);
         change_state(STATE_PLAYING);
     }
 }
@@ -121,6 +125,17 @@ void handle_fast_drop_state(void) {
     }
 }
 
+void handle_hard_drop_state(void) {
+    // Straight to the landing spot, scored as if it fell cell by cell
+    int8_t land = landing_z(shape_orient, shape_pos_x, shape_pos_y, shape_pos_z);
+    if (land > shape_pos_z) {
+        score += 2 * (uint8_t)(land - shape_pos_z);
+        shape_pos_z = land;
+        mark_hud_dirty();
+    }
+    change_state(STATE_LOCKING);
+}
+
 void handle_locking_state(void) {
     // Grace period - allow last moment moves
     state.lock_delay--;
@@ -143,7 +158,7 @@ void handle_locking_state(void) {
 /* ================= INPUT HANDLING BY STATE ================= */
 
 void handle_movement_input(void) {
-    if (key(KEY_LEFT)) {
+    if (action(ACT_LEFT)) {
         if (is_position_valid(shape_pos_x - 1, shape_pos_y, shape_pos_z)) {
             shape_pos_x--;
             if (state.current == STATE_LOCKING) {
@@ -151,7 +166,7 @@ void handle_movement_input(void) {
             }
         }
     }
-    if (key(KEY_RIGHT)) {
+    if (action(ACT_RIGHT)) {
         if (is_position_valid(shape_pos_x + 1, shape_pos_y, shape_pos_z)) {
             shape_pos_x++;
             if (state.current == STATE_LOCKING) {
@@ -159,7 +174,7 @@ void handle_movement_input(void) {
             }
         }
     }
-    if (key(KEY_UP)) {
+    if (action(ACT_UP)) {
         if (is_position_valid(shape_pos_x, shape_pos_y - 1, shape_pos_z)) {
             shape_pos_y--;
             if (state.current == STATE_LOCKING) {
@@ -167,7 +182,7 @@ void handle_movement_input(void) {
             }
         }
     }
-    if (key(KEY_DOWN)) {
+    if (action(ACT_DOWN)) {
         if (is_position_valid(shape_pos_x, shape_pos_y + 1, shape_pos_z)) {
             shape_pos_y++;
             if (state.current == STATE_LOCKING) {
@@ -176,12 +191,12 @@ void handle_movement_input(void) {
         }
     }
     
-    if (key(KEY_EQUAL) || key(KEY_KPEQUAL)) {
+    if (action(ACT_RAISE)) {
         if (is_position_valid(shape_pos_x, shape_pos_y, shape_pos_z - 1)) {
             shape_pos_z--;
         }
     }
-    if (key(KEY_MINUS)) {
+    if (action(ACT_LOWER)) {
         if (is_position_valid(shape_pos_x, shape_pos_y, shape_pos_z + 1)) {
             shape_pos_z++;
         }
@@ -189,33 +204,26 @@ void handle_movement_input(void) {
 }
 
 void handle_rotation_input(void) {
-    int8_t kX, kY, kZ;
-    uint8_t nextX = targetX, nextY = targetY, nextZ = targetZ;
-    bool rotation_requested = false;
-
-    if (key(KEY_Q)) { nextX += ANGLE_STEP_90; rotation_requested = true; }
-    if (key(KEY_W)) { nextY += ANGLE_STEP_90; rotation_requested = true; }
-    if (key(KEY_E)) { nextZ += ANGLE_STEP_90; rotation_requested = true; }
-    if (key(KEY_A)) { nextX -= ANGLE_STEP_90; rotation_requested = true; }
-    if (key(KEY_S)) { nextY -= ANGLE_STEP_90; rotation_requested = true; }
-    if (key(KEY_D)) { nextZ -= ANGLE_STEP_90; rotation_requested = true; }
-
-    if (rotation_requested) {
-        if (try_wall_kick(nextX, nextY, nextZ, &kX, &kY, &kZ)) {
-            shape_pos_x = kX;
-            shape_pos_y = kY;
-            shape_pos_z = kZ;
-            targetX = nextX;
-            targetY = nextY;
-            targetZ = nextZ;
-            change_state(STATE_ANIMATING);
+    // One quarter turn per frame, first pressed key wins
+    for (uint8_t t = 0; t < NUM_TURNS; t++) {
+        if (!action(ACT_TURN_X_POS + t)) continue;
+
+        uint8_t nextX = targetX, nextY = targetY, nextZ = targetZ;
+        int8_t step = (t < TURN_X_NEG) ? ANGLE_STEP_90 : -ANGLE_STEP_90;
+        switch (t % 3) {
+            case 0: nextX += step; break;
+            case 1: nextY += step; break;
+            default: nextZ += step; break;
         }
+        begin_rotation(orient_next[shape_orient][t], nextX, nextY, nextZ);
+        return;
     }
 }
 
 void handle_playing_input(void) {
-    if (key(KEY_SPACE)) {
-        change_state(STATE_FAST_DROP);
+    if (action(ACT_DROP)) {
+        change_state(STATE_HARD_DROP);
+        return;
     }
     handle_movement_input();
     handle_rotation_input();
@@ -228,16 +236,8 @@ void handle_locking_input(void) {
 }
 
 void handle_game_over_input(void) {
-    if (key(KEY_R)) {
-        // clear pit
-        for (uint8_t z = 0; z < MAX_PIT_HEIGHT; z++) {
-            for (uint8_t y = 0; y < MAX_PIT_DEPTH; y++) {
-                for (uint8_t x = 0; x < MAX_PIT_WIDTH; x++) {
-                    pit[z][y][x] = 0;
-                    pit_colors[z][y][x] = 0;
-                }
-            }
-        }
+    if (action(ACT_RESTART)) {
+        pit_clear();
         change_state(STATE_START_SCREEN);
     }
 }
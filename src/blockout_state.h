@@ -23,6 +23,8 @@ void handle_locking_state(void);
 
 void handle_fast_drop_state(void);
 
+void handle_hard_drop_state(void);
+
 void handle_start_screen_state(void);
 
 /* ================= INPUT HANDLING BY STATE ================= */
@@ -3,12 +3,14 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "shape_set.h" // NUM_SHAPES, MAX_BLOCKS, MAX_VERTICES; generated by tools/shapes2c.py
 
 #define SCREEN_WIDTH 320
 #define SCREEN_HEIGHT 180
 #define VIEWPORT_WIDTH 180
 #define VIEWPORT_HEIGHT 180
 #define VIEWPORT_SIZE (VIEWPORT_WIDTH * VIEWPORT_HEIGHT / 2) 
+#define STATIC_SIZE (SCREEN_WIDTH * SCREEN_HEIGHT / 2)
 
 #define VIEWPORT_X 32 
 #define VIEWPORT_Y ((SCREEN_HEIGHT - VIEWPORT_HEIGHT) / 2)
@@ -23,10 +25,15 @@
 #define VIEWPORT_STRUCT_ADDR 0xFE80
 #define PSG_BASE             0xFEC0
 
-#define NUM_POINTS 256
+// Unused XRAM between the second viewport buffer and the plane structs,
+// used to save whatever an overlay banner covers
+#define SCRATCH_XRAM_ADDR    (VIEWPORT_BUFFER_1 + VIEWPORT_SIZE)
+#define SCRATCH_XRAM_SIZE    (STATIC_STRUCT_ADDR - SCRATCH_XRAM_ADDR)
+#define PAUSE_SAVE_ADDR      SCRATCH_XRAM_ADDR
+#define GAME_OVER_SAVE_ADDR  (SCRATCH_XRAM_ADDR + 0x0800)
+#define PROFILE_SAVE_ADDR    (SCRATCH_XRAM_ADDR + 0x0D00)
 
-#define GRID_SIZE        (VIEWPORT_WIDTH / PIT_WIDTH)
-#define CUBE_SIZE        (GRID_SIZE / 2)
+#define NUM_POINTS 256
 
 #define WORLD_HALF_W     (VIEWPORT_WIDTH / 2)
 #define WORLD_HALF_H     (VIEWPORT_HEIGHT / 2)
@@ -34,41 +41,47 @@
 #define PIT_Z_START      64
 #define PIT_Z_STEP       12
 
-#define MAX_PIT_WIDTH 5
-#define MAX_PIT_DEPTH 5
-#define MAX_PIT_HEIGHT 8
+// Oblique view: each layer deeper shifts down-right by a quarter cell
+#define OBLIQUE_DEPTH_SHIFT 2
+
+#define MAX_PIT_WIDTH 7   // A pit row must fit in one byte of pit_rows
+#define MAX_PIT_DEPTH 7
+#define MAX_PIT_HEIGHT 12
+#define MIN_PIT_WIDTH 3
+#define MIN_PIT_DEPTH 3
+#define MIN_PIT_HEIGHT 4
+
+#define NUM_PIT_PRESETS 4
+#define PIT_SIZE_CUSTOM 0xFF   // selected_pit_size after a dimension was set by hand
 
 // Runtime pit size (set at game start)
 extern uint8_t PIT_WIDTH;
 extern uint8_t PIT_DEPTH;
 extern uint8_t PIT_HEIGHT;
-extern uint8_t selected_pit_size; // 0=3x3, 1=4x4, 2=5x5
+extern uint8_t selected_pit_size; // 0=3x3, 1=4x4, 2=5x5, 3=7x7x12
 
-#define MAX_BLOCKS 4
-#define NUM_SHAPES 8
 #define NUM_ZOOM_LEVELS 8
+#define ZOOM_DEFAULT 3         // zoom_lut entry of the plain perspective view
+#define ZOOM_CACHE_SLOTS 2     // Grid tables kept for levels other than the default
 #define NUM_MODES 4
 
 #define ROTATION_STEPS 3
 #define ANGLE_STEP_90 (256/4)
 
-#define FILL_STRIDE 1
+// A pass that overruns its frame halves the static fills; the other rows
+// are filled in once this many passes in a row have kept to one vsync
+#define QUALITY_SLACK_FRAMES 30
 
 #define LEVEL_INDICATOR_WIDTH 14
+#define LEVEL_INDICATOR_SPAN 112   // Height shared by all layers
 
 /* ================= SHAPES ================= */
 
-#define MASK_FACE_RIGHT  ((1<<1)|(1<<5)|(1<<9)|(1<<10))
-#define MASK_FACE_LEFT   ((1<<3)|(1<<7)|(1<<8)|(1<<11))
-#define MASK_FACE_TOP    ((1<<2)|(1<<6)|(1<<10)|(1<<11))
-#define MASK_FACE_BOTTOM ((1<<0)|(1<<4)|(1<<8)|(1<<9))
-#define MASK_FACE_FRONT  ((1<<4)|(1<<5)|(1<<6)|(1<<7))
-#define MASK_FACE_BACK   ((1<<0)|(1<<1)|(1<<2)|(1<<3))
-
 typedef enum {
     STATE_PLAYING,      // Normal gameplay
     STATE_ANIMATING,    // Shape is rotating (blocks most input)
-    STATE_FAST_DROP,    // Space bar held - dropping fast
+    STATE_FAST_DROP,    // Dropping one cell per frame (demo)
+    STATE_HARD_DROP,    // Space bar - lands in a single step
     STATE_LOCKING,      // Shape just hit bottom, about to lock
     STATE_PAUSED,       // Game paused
     STATE_GAME_OVER,     // Game over
@@ -91,13 +104,18 @@ typedef struct {
     uint8_t num_blocks;
     const char *name;
     const int8_t offsets[MAX_BLOCKS][3];
-    const uint16_t edge_masks[MAX_BLOCKS];
     const int8_t center[3]; // Values are in half-blocks (1 = 0.5 blocks)
+    const int8_t (*orient_offsets)[3]; // NUM_ORIENTS x num_blocks, orientation-major
+    uint8_t num_vertices;
+    uint8_t num_edges;
+    const uint8_t *vertices;       // Unique wireframe corners, (block << 3) | cube corner
+    const uint8_t (*edges)[2];     // Unique outline edges, indices into vertices
 } Shape;
 
 // Global variable declarations
 
 extern uint8_t LEVEL_INDICATOR_HEIGHT; 
+extern uint8_t level_indicator_step;
 
 extern uint32_t score;
 extern uint16_t cubes_played;
@@ -113,7 +131,8 @@ extern uint16_t seed;
 
 extern uint8_t active_buffer;
 
-extern bool perspective_enabled;
+extern bool perspective_enabled;   // false = oblique view
+extern bool shadow_enabled;
 extern uint8_t zoom_level;
 extern uint8_t mode;
 extern char text_buffer[24];
@@ -30,13 +30,22 @@ static struct channel
     uint16_t xaddr;
     uint8_t duration;
     uint8_t release;
+    uint8_t priority;
+    uint8_t stamp;
 } ezpsg_channels[PSG_CHANNELS];
 
 static struct channel *ezpsg_channels_free;
 static struct channel *ezpsg_channels_playing;
 static struct channel *ezpsg_channels_releasing;
+static uint8_t ezpsg_frame;
 
 static const uint8_t *ezpsg_song;
+static const uint8_t *ezpsg_loop_mark;
+static uint8_t ezpsg_loop_left;
+static bool ezpsg_song_due;
+static const ezpsg_instrument_t *ezpsg_instruments;
+static const ezpsg_instrument_t *ezpsg_instrument;
+static unsigned ezpsg_durations;
 
 void ezpsg_init(uint16_t xaddr)
 {
@@ -60,13 +69,77 @@ void ezpsg_init(uint16_t xaddr)
     ezpsg_channels_releasing = NULL;
     // Clear song.
     ezpsg_song = NULL;
+    ezpsg_song_due = false;
+}
+
+// Play song events until a wait, the end, or the per-tick budget.
+static void ezpsg_song_events(void)
+{
+    uint8_t budget = EZPSG_EVENTS_PER_TICK;
+    while (budget--)
+    {
+        uint8_t op = *ezpsg_song;
+        if (op == EZPSG_END)
+        {
+            ezpsg_song = NULL;
+            ezpsg_song_due = false;
+            return;
+        }
+        if (op < EZPSG_NOTE(0))
+        {
+            ezpsg_durations = op;
+            ezpsg_song++;
+            ezpsg_song_due = false;
+            return;
+        }
+        ezpsg_song++;
+        if (op < EZPSG_INSTRUMENT(0))
+        {
+            uint8_t duration = *ezpsg_song++;
+            const ezpsg_instrument_t *i = ezpsg_instrument;
+            if (i)
+                ezpsg_play_note(op - EZPSG_NOTE(0), duration, i->release, i->duty,
+                                i->vol_attack, i->vol_decay, i->wave_release, i->pan);
+        }
+        else if (op < EZPSG_MARK)
+        {
+            if (ezpsg_instruments)
+                ezpsg_instrument = &ezpsg_instruments[op - EZPSG_INSTRUMENT(0)];
+        }
+        else if (op == EZPSG_MARK)
+        {
+            ezpsg_loop_mark = ezpsg_song;
+            ezpsg_loop_left = 0;
+        }
+        else if (op == EZPSG_LOOP)
+        {
+            uint8_t count = *ezpsg_song++;
+            if (count == 0)
+                ezpsg_song = ezpsg_loop_mark;
+            else if (ezpsg_loop_left == 0)
+            {
+                ezpsg_loop_left = count;
+                ezpsg_song = ezpsg_loop_mark;
+            }
+            else if (--ezpsg_loop_left)
+                ezpsg_song = ezpsg_loop_mark;
+        }
+    }
 }
 
 bool ezpsg_tick(uint16_t tempo)
 {
     static unsigned ticks = 0;
-    static unsigned durations = 0;
     struct channel *channel;
+    bool song_ran = false;
+    // Voices programmed before this tick may be stolen again.
+    ezpsg_frame++;
+    // Song events left over from a busy tick.
+    if (ezpsg_song_due && ezpsg_song)
+    {
+        ezpsg_song_events();
+        song_ran = true;
+    }
     // Just before the last tick we release everything that's done playing.
     if (ticks == 1)
     {
@@ -118,16 +191,16 @@ bool ezpsg_tick(uint16_t tempo)
             channel = channel->next;
         }
         // We may have been asked to wait multiple durations.
-        if (durations > 1)
-            durations--;
-        // // Play all the instruments then go back to waiting.
-        // else if (ezpsg_song)
-        // {
-        //     while ((int8_t)*ezpsg_song < 0)
-        //         ezpsg_instruments(&ezpsg_song);
-        //     if ((int8_t)*ezpsg_song > 0)
-        //         durations = *ezpsg_song++;
-        // }
+        if (ezpsg_durations > 1)
+            ezpsg_durations--;
+        // Play the song up to its next wait.
+        // Only one event budget per tick, the rest waits a tick.
+        else if (ezpsg_song)
+        {
+            ezpsg_song_due = true;
+            if (!song_ran)
+                ezpsg_song_events();
+        }
         ticks = tempo;
         return true;
     }
@@ -136,24 +209,64 @@ bool ezpsg_tick(uint16_t tempo)
     return false;
 }
 
-uint16_t ezpsg_play_note(uint8_t note,
-                         uint8_t duration,
-                         uint8_t release,
-                         uint8_t duty,
-                         uint8_t vol_attack,
-                         uint8_t vol_decay,
-                         uint8_t wave_release,
-                         int8_t pan)
+// Find the best voice to steal in one list: lowest priority first,
+// then the one programmed longest ago. Voices programmed during this
+// tick are never taken. Returns the link pointing at the victim.
+static struct channel **ezpsg_steal_link(struct channel **link, uint8_t priority)
+{
+    struct channel **best = NULL;
+    uint8_t best_age = 0;
+    for (; *link; link = &(*link)->next)
+    {
+        struct channel *c = *link;
+        uint8_t age = ezpsg_frame - c->stamp;
+        if (age == 0 || c->priority > priority)
+            continue;
+        if (!best || c->priority < (*best)->priority ||
+            (c->priority == (*best)->priority && age > best_age))
+        {
+            best = link;
+            best_age = age;
+        }
+    }
+    return best;
+}
+
+uint16_t ezpsg_play_note_priority(uint8_t priority,
+                                  uint8_t note,
+                                  uint8_t duration,
+                                  uint8_t release,
+                                  uint8_t duty,
+                                  uint8_t vol_attack,
+                                  uint8_t vol_decay,
+                                  uint8_t wave_release,
+                                  int8_t pan)
 {
     struct channel **playing = &ezpsg_channels_playing;
     // Convert note to frequency in hertz
     static const uint16_t freq_conv[] = {EZPSG_NOTE_FREQS};
     uint16_t freq = freq_conv[note];
-    // Obtain a free channel or do nothing
+    // Obtain a free channel
     struct channel *channel = ezpsg_channels_free;
-    if (!channel)
+    if (channel)
+        ezpsg_channels_free = channel->next;
+    else if (priority == EZPSG_PRIORITY_NONE)
         return 0xFFFF;
-    ezpsg_channels_free = channel->next;
+    else
+    {
+        // Steal a voice, preferring ones already in their release tail.
+        struct channel **link = ezpsg_steal_link(&ezpsg_channels_releasing, priority);
+        if (!link)
+            link = ezpsg_steal_link(&ezpsg_channels_playing, priority);
+        if (!link)
+            return 0xFFFF;
+        channel = *link;
+        *link = channel->next;
+        // Drop the old gate before reprogramming.
+        RIA.addr0 = channel->xaddr + (unsigned)(&((ria_psg_t *)0)->pan_gate);
+        RIA.step0 = 0;
+        RIA.rw0 &= 0xFE;
+    }
     // Move channel into playling list, ordered by duration
     while (*playing && duration > (*playing)->duration)
         playing = &(*playing)->next;
@@ -162,6 +275,8 @@ uint16_t ezpsg_play_note(uint8_t note,
     // Set the countdowns
     channel->duration = duration;
     channel->release = release;
+    channel->priority = priority;
+    channel->stamp = ezpsg_frame;
     // Program the XRAM registers
     RIA.addr0 = channel->xaddr;
     RIA.step0 = 1;
@@ -177,9 +292,32 @@ uint16_t ezpsg_play_note(uint8_t note,
     return channel->xaddr;
 }
 
+uint16_t ezpsg_play_note(uint8_t note,
+                         uint8_t duration,
+                         uint8_t release,
+                         uint8_t duty,
+                         uint8_t vol_attack,
+                         uint8_t vol_decay,
+                         uint8_t wave_release,
+                         int8_t pan)
+{
+    return ezpsg_play_note_priority(EZPSG_PRIORITY_NONE, note, duration, release,
+                                    duty, vol_attack, vol_decay, wave_release, pan);
+}
+
+void ezpsg_set_instruments(const ezpsg_instrument_t *instruments)
+{
+    ezpsg_instruments = instruments;
+    ezpsg_instrument = instruments;
+}
+
 void ezpsg_play_song(const uint8_t *song)
 {
     ezpsg_song = song;
+    ezpsg_loop_mark = song;
+    ezpsg_loop_left = 0;
+    ezpsg_durations = 0;
+    ezpsg_song_due = false;
 }
 
 bool ezpsg_playing(void)
@@ -187,7 +187,57 @@ uint16_t ezpsg_play_note(uint8_t note,
                          uint8_t wave_release,
                          int8_t pan);
 
-// Play song will move the song pointer to new music.
+// Play note with a priority. When every channel is busy, a note with
+// a priority above EZPSG_PRIORITY_NONE steals the channel of equal or
+// lower priority that was programmed longest ago, trying releasing
+// channels before playing ones. A channel is never stolen in the same
+// tick it was programmed. Plain ezpsg_play_note and songs use
+// EZPSG_PRIORITY_NONE, which never steals but may be stolen from.
+#define EZPSG_PRIORITY_NONE 0
+uint16_t ezpsg_play_note_priority(uint8_t priority,
+                                  uint8_t note,
+                                  uint8_t duration,
+                                  uint8_t release,
+                                  uint8_t duty,
+                                  uint8_t vol_attack,
+                                  uint8_t vol_decay,
+                                  uint8_t wave_release,
+                                  int8_t pan);
+
+// Songs are byte streams, usually compiled by tools/song2c.py:
+//   0x00       end of song
+//   0x01-0x7F  wait that many duration units
+//   0x80-0xDF  play note (op - 0x80) with the current instrument,
+//              followed by a duration byte
+//   0xE0-0xEF  select instrument (op - 0xE0)
+//   0xF0       loop mark
+//   0xF1       jump back to the mark, followed by a count byte:
+//              repeat that many times, 0 repeats forever
+#define EZPSG_END            0x00
+#define EZPSG_NOTE(n)        (0x80 + (n))
+#define EZPSG_INSTRUMENT(i)  (0xE0 + (i))
+#define EZPSG_MARK           0xF0
+#define EZPSG_LOOP           0xF1
+
+// At most this many song events are played per tick. A denser spot
+// spills over into the next ticks of the same duration unit.
+#define EZPSG_EVENTS_PER_TICK 4
+
+typedef struct
+{
+    uint8_t release;
+    uint8_t duty;
+    uint8_t vol_attack;
+    uint8_t vol_decay;
+    uint8_t wave_release;
+    int8_t pan;
+} ezpsg_instrument_t;
+
+// Instrument table indexed by the song's instrument selects.
+void ezpsg_set_instruments(const ezpsg_instrument_t *instruments);
+
+// Play song will move the song pointer to new music. NULL stops the song;
+// notes already sounding finish on their own.
 void ezpsg_play_song(const uint8_t *song);
 
 // Returns true if a song is playing. Turns false at end of song.
@@ -5,6 +5,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include "blockout_types.h"
+#include "music_theme.h"
 
 // Keep track of the continuous thrust sound
 static bool is_thrust_playing = false;
@@ -24,24 +25,55 @@ static uint8_t beat_timer = 0;
 static uint8_t beat_interval = 60;  // Frames between beats (starts slow)
 static bool beat_low = true;         // Alternates between two tones
 
+// Instruments used by the songs, indexed by their 'inst' numbers
+static const ezpsg_instrument_t music_instruments[] = {
+    // release, duty, vol_attack, vol_decay, wave_release, pan
+    {2, 0x80, 0x70, 0xA4, EZPSG_WAVE_SQUARE | 0x03, EZPSG_PAN_CENTER},  // 0: lead
+    {1, 0x80, 0x50, 0x83, EZPSG_WAVE_TRI | 0x02, EZPSG_PAN_CENTER},     // 1: bass
+};
+
 // Initialize the sound system
 void init_sound(void) {
 
     ezpsg_init(PSG_BASE);
+    ezpsg_set_instruments(music_instruments);
+}
+
+void start_music(void) {
+    ezpsg_play_song(theme_song);
 }
 
-// Interpolated sound state
+void stop_music(void) {
+    ezpsg_play_song(NULL);
+}
+
+// Swept parameters, in the order ezpsg_play_note() takes them
+enum {
+    SWEEP_NOTE,
+    SWEEP_DUTY,
+    SWEEP_VOL_ATTACK,
+    SWEEP_VOL_DECAY,
+    SWEEP_WAVE,
+    SWEEP_PAN,
+    SWEEP_PARAMS
+};
+
+// Pan is kept in offset binary so every parameter sweeps as unsigned
+#define SWEEP_PAN_BIAS 0x80
+
+// Interpolated sound state. Each parameter is an 8.8 fixed-point
+// accumulator; the high byte is the value played on the current step.
+// Deltas are stored as 16-bit two's complement and added modulo 2^16,
+// so a falling sweep is just a large unsigned delta.
 typedef struct InterpolatedSoundHandle {
-    uint8_t start_note, end_note;
-    uint8_t start_duty, end_duty;
-    uint8_t start_vol_attack, end_vol_attack;
-    uint8_t start_vol_decay, end_vol_decay;
-    uint8_t start_wave, end_wave;
-    int8_t start_pan, end_pan;
+    uint16_t value[SWEEP_PARAMS];
+    uint16_t delta[SWEEP_PARAMS];
+    uint8_t start[SWEEP_PARAMS];
     uint8_t note_duration;
     uint8_t release;
     uint8_t total_steps;
     uint8_t current_step;
+    uint8_t priority;
     uint8_t frame_counter;
     bool loop;
     bool active;
@@ -50,20 +82,26 @@ typedef struct InterpolatedSoundHandle {
 
 static InterpolatedSound interp_sounds[MAX_INTERPOLATED_SOUNDS] = {0};
 
-// Helper function to interpolate between two uint8_t values
-static uint8_t interpolate_u8(uint8_t start, uint8_t end, uint8_t step, uint8_t total_steps) {
-    if (total_steps <= 1) return start;
-    int32_t diff = (int32_t)end - (int32_t)start;
-    int32_t result = start + (diff * step) / (total_steps - 1);
-    return (uint8_t)result;
+// Rewind every accumulator to its start value. The low byte starts at one
+// half so the truncated high byte rounds to the nearest step value.
+static void rewind_interpolated_sound(InterpolatedSound *sound) {
+    for (uint8_t p = 0; p < SWEEP_PARAMS; p++) {
+        sound->value[p] = ((uint16_t)sound->start[p] << 8) | 0x80;
+    }
+    sound->current_step = 0;
 }
 
-// Helper function to interpolate between two int8_t values (for pan)
-static int8_t interpolate_i8(int8_t start, int8_t end, uint8_t step, uint8_t total_steps) {
-    if (total_steps <= 1) return start;
-    int32_t diff = (int32_t)end - (int32_t)start;
-    int32_t result = start + (diff * step) / (total_steps - 1);
-    return (int8_t)result;
+// Set up one parameter's start value and 8.8 per-step delta. This is the
+// only division in the sweep; stepping afterwards is a 16-bit add.
+static void set_sweep(InterpolatedSound *sound, uint8_t p,
+                      uint8_t start, uint8_t end, uint8_t steps) {
+    sound->start[p] = start;
+    if (steps <= 1 || start == end) {
+        sound->delta[p] = 0;
+        return;
+    }
+    int16_t diff = (int16_t)end - (int16_t)start;
+    sound->delta[p] = (uint16_t)(((int32_t)diff << 8) / (steps - 1));
 }
 
 InterpSoundHandle start_interpolated_sound(uint8_t start_note, uint8_t end_note,
@@ -73,7 +111,8 @@ InterpSoundHandle start_interpolated_sound(uint8_t start_note, uint8_t end_note,
                                            uint8_t start_wave, uint8_t end_wave,
                                            int8_t start_pan, int8_t end_pan,
                                            uint8_t note_duration, uint8_t release,
-                                           uint8_t steps, bool loop) {
+                                           uint8_t steps, bool loop,
+                                           uint8_t priority) {
     
     if (steps == 0) return NULL;
     
@@ -89,26 +128,23 @@ InterpSoundHandle start_interpolated_sound(uint8_t start_note, uint8_t end_note,
     // No free slots available
     if (!sound) return NULL;
     
-    // Store parameters
-    sound->start_note = start_note;
-    sound->end_note = end_note;
-    sound->start_duty = start_duty;
-    sound->end_duty = end_duty;
-    sound->start_vol_attack = start_vol_attack;
-    sound->end_vol_attack = end_vol_attack;
-    sound->start_vol_decay = start_vol_decay;
-    sound->end_vol_decay = end_vol_decay;
-    sound->start_wave = start_wave;
-    sound->end_wave = end_wave;
-    sound->start_pan = start_pan;
-    sound->end_pan = end_pan;
+    // Precompute the per-step deltas
+    set_sweep(sound, SWEEP_NOTE, start_note, end_note, steps);
+    set_sweep(sound, SWEEP_DUTY, start_duty, end_duty, steps);
+    set_sweep(sound, SWEEP_VOL_ATTACK, start_vol_attack, end_vol_attack, steps);
+    set_sweep(sound, SWEEP_VOL_DECAY, start_vol_decay, end_vol_decay, steps);
+    set_sweep(sound, SWEEP_WAVE, start_wave, end_wave, steps);
+    set_sweep(sound, SWEEP_PAN,
+              (uint8_t)(start_pan + SWEEP_PAN_BIAS),
+              (uint8_t)(end_pan + SWEEP_PAN_BIAS), steps);
     sound->note_duration = note_duration;
     sound->release = release;
     sound->total_steps = steps;
     sound->loop = loop;
+    sound->priority = priority;
     
     // Initialize state
-    sound->current_step = 0;
+    rewind_interpolated_sound(sound);
     sound->frame_counter = 0;
     sound->active = true;
     sound->psg_addr = 0xFFFF;
@@ -135,48 +171,31 @@ void update_interpolated_sounds(void) {
         if (sound->frame_counter >= sound->note_duration) {
             sound->frame_counter = 0;
             
-            // Calculate interpolated parameters for current step
-            uint8_t note = interpolate_u8(sound->start_note, 
-                                           sound->end_note, 
-                                           sound->current_step, 
-                                           sound->total_steps);
-            uint8_t duty = interpolate_u8(sound->start_duty, 
-                                           sound->end_duty, 
-                                           sound->current_step, 
-                                           sound->total_steps);
-            uint8_t vol_attack = interpolate_u8(sound->start_vol_attack, 
-                                                 sound->end_vol_attack, 
-                                                 sound->current_step, 
-                                                 sound->total_steps);
-            uint8_t vol_decay = interpolate_u8(sound->start_vol_decay, 
-                                                sound->end_vol_decay, 
-                                                sound->current_step, 
-                                                sound->total_steps);
-            uint8_t wave = interpolate_u8(sound->start_wave, 
-                                           sound->end_wave, 
-                                           sound->current_step, 
-                                           sound->total_steps);
-            int8_t pan = interpolate_i8(sound->start_pan, 
-                                         sound->end_pan, 
-                                         sound->current_step, 
-                                         sound->total_steps);
-            
             // Determine if this is the last note
             bool is_last = (sound->current_step == sound->total_steps - 1);
             uint8_t note_release = (is_last && !sound->loop) ? sound->release : 0;
             
-            // Play the note
-            sound->psg_addr = ezpsg_play_note(note, sound->note_duration, 
-                                              note_release, duty, vol_attack, 
-                                              vol_decay, wave, pan);
+            // Play the note at the current accumulator values
+            sound->psg_addr = ezpsg_play_note_priority(sound->priority,
+                                                       sound->value[SWEEP_NOTE] >> 8,
+                                                       sound->note_duration, 
+                                                       note_release,
+                                                       sound->value[SWEEP_DUTY] >> 8,
+                                                       sound->value[SWEEP_VOL_ATTACK] >> 8,
+                                                       sound->value[SWEEP_VOL_DECAY] >> 8,
+                                                       sound->value[SWEEP_WAVE] >> 8,
+                                                       (int8_t)((sound->value[SWEEP_PAN] >> 8) - SWEEP_PAN_BIAS));
             
             // Advance to next step
             sound->current_step++;
+            for (uint8_t p = 0; p < SWEEP_PARAMS; p++) {
+                sound->value[p] += sound->delta[p];
+            }
             
             // Handle looping or stopping
             if (sound->current_step >= sound->total_steps) {
                 if (sound->loop) {
-                    sound->current_step = 0;  // Loop back to start
+                    rewind_interpolated_sound(sound);  // Loop back to start
                 } else {
                     sound->active = false;  // Stop after sequence completes
                 }
@@ -185,8 +204,8 @@ void update_interpolated_sounds(void) {
     }
 }
 
-// Example usage - Looping alarm sound (plays continuously in background)
-InterpSoundHandle start_game_over_sound(void) {
+// Falling sweep when the game ends
+static InterpSoundHandle start_game_over_sound(void) {
     return start_interpolated_sound(
         c5, c2,           // Start note, End note (sweep up 2 octaves)
         0x80, 0xFF,       // Start duty, End duty
@@ -197,15 +216,17 @@ InterpSoundHandle start_game_over_sound(void) {
         2,                // Duration per note (frames)
         10,               // Release on final note
         30,               // Number of steps
-        false              // Loop continuously
+        false,             // Loop continuously
+        SOUND_PRIORITY_GAME_OVER
     );
 }
 
 
 // --- Sound Effect Definitions ---
 
-void play_drop_sound(void) {
-    ezpsg_play_note(d1,   // note
+static void play_drop_sound(void) {
+    ezpsg_play_note_priority(SOUND_PRIORITY_DROP,
+                        d1,   // note
                         5,    // duration
                         0,    // release
                         155,   // duty
@@ -216,8 +237,9 @@ void play_drop_sound(void) {
     
 }
 
-void play_clear_level_sound(void) {
-    ezpsg_play_note(gs3,   // note
+static void play_clear_level_sound(void) {
+    ezpsg_play_note_priority(SOUND_PRIORITY_CLEAR,
+                        gs3,   // note
                         10,    // duration
                         10,    // release
                         191,   // duty
@@ -228,8 +250,31 @@ void play_clear_level_sound(void) {
     
 }
 
-void play_clear_level_all_sound(void) {
-    ezpsg_play_note(cs5,   // note
+// Short rising arpeggio for one cleared layer. Each further layer in the
+// same clear starts a major third higher and alternates sides, so a
+// multi-layer clear stacks into a chord.
+static void play_clear_layer_sweep(uint8_t index) {
+    if (index > 3) index = 3;
+    uint8_t root = gs3 + 4 * index;
+    int8_t pan = (index & 1) ? EZPSG_PAN_RIGHT / 2 : EZPSG_PAN_LEFT / 2;
+    start_interpolated_sound(
+        root, root + 12,  // Start note, End note (up an octave)
+        0x80, 0x80,       // Duty (constant)
+        0x18, 0x28,       // vol_attack
+        0xC6, 0xF8,       // vol_decay (fading out)
+        EZPSG_WAVE_TRI | 0x02, EZPSG_WAVE_TRI | 0x02,  // Wave (constant)
+        pan, 0,           // Pan drifts to center
+        3,                // Duration per note (frames)
+        6,                // Release on final note
+        4,                // Number of steps
+        false,
+        SOUND_PRIORITY_SWEEP
+    );
+}
+
+static void play_clear_level_all_sound(void) {
+    ezpsg_play_note_priority(SOUND_PRIORITY_CLEAR,
+                        cs5,   // note
                         10,    // duration
                         10,    // release
                         191,   // duty
@@ -240,10 +285,49 @@ void play_clear_level_all_sound(void) {
     
 }
 
+// --- Sound Event Queue ---
+
+// Events posted since the last tick, one bit per SoundEvent. Posting an
+// event twice in a frame sets the same bit, so it plays once.
+static uint8_t pending_sounds = 0;
+// Layers cleared since the last tick, one arpeggio sweep each
+static uint8_t pending_clear_layers = 0;
+
+void post_sound(SoundEvent event) {
+    pending_sounds |= 1 << event;
+    if (event == SOUND_CLEAR_LAYER && pending_clear_layers < 4) {
+        pending_clear_layers++;
+    }
+}
+
+// Play everything posted since the last tick, highest priority first so
+// the important effects get first pick of the free voices.
+static void resolve_sound_events(void) {
+    if (!pending_sounds) return;
+    if (pending_sounds & (1 << SOUND_GAME_OVER)) {
+        start_game_over_sound();
+    }
+    if (pending_sounds & (1 << SOUND_CLEAR_ALL)) {
+        play_clear_level_all_sound();
+    }
+    if (pending_sounds & (1 << SOUND_CLEAR_LAYER)) {
+        play_clear_level_sound();
+        for (uint8_t i = 0; i < pending_clear_layers; i++) {
+            play_clear_layer_sweep(i);
+        }
+    }
+    if (pending_sounds & (1 << SOUND_DROP)) {
+        play_drop_sound();
+    }
+    pending_sounds = 0;
+    pending_clear_layers = 0;
+}
+
 // This function must be called every frame in your main game loop
 void update_sound(void) {
 
     ezpsg_tick(1);
+    resolve_sound_events();
 
     if (is_thrust_playing && thrust_channel_xaddr != 0xFFFF) {
         uint8_t pan_gate;
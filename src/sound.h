@@ -14,7 +14,23 @@
 #define EZPSG_PAN_RIGHT   63
 #define EZPSG_PAN_CENTER  0 // Both left and right
 
-#define MAX_INTERPOLATED_SOUNDS 4
+#define MAX_INTERPOLATED_SOUNDS 8
+
+// Voice priorities for ezpsg_play_note_priority(). When all PSG voices
+// are busy a sound may steal one of equal or lower priority.
+#define SOUND_PRIORITY_DROP      1
+#define SOUND_PRIORITY_SWEEP     2
+#define SOUND_PRIORITY_CLEAR     3
+#define SOUND_PRIORITY_GAME_OVER 4
+
+// Sound events posted by gameplay code and played on the next tick
+typedef enum {
+    SOUND_DROP,
+    SOUND_CLEAR_LAYER,   // Post once per cleared layer
+    SOUND_CLEAR_ALL,
+    SOUND_GAME_OVER,
+    SOUND_EVENT_COUNT
+} SoundEvent;
 
 typedef struct InterpolatedSoundHandle* InterpSoundHandle;
 
@@ -25,20 +41,18 @@ InterpSoundHandle start_interpolated_sound(uint8_t start_note, uint8_t end_note,
                                            uint8_t start_wave, uint8_t end_wave,
                                            int8_t start_pan, int8_t end_pan,
                                            uint8_t note_duration, uint8_t release,
-                                           uint8_t steps, bool loop);
+                                           uint8_t steps, bool loop,
+                                           uint8_t priority);
 void stop_interpolated_sound(InterpSoundHandle handle);
 void update_interpolated_sounds(void);  
 
 void init_sound(void);
 void update_sound(void);
 
+void start_music(void);
+void stop_music(void);
 
-
-void play_drop_sound(void); 
-void play_clear_level_sound(void);
-void play_clear_level_all_sound(void);
-
-InterpSoundHandle start_game_over_sound(void);
+void post_sound(SoundEvent event);
 
 
 
@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+#
+# Run-length pack a raw 4bpp image for the RP6502 ROM filesystem.
+#
+# Packets start with a control byte:
+#   0x00-0x7F  copy the next (c + 1) bytes
+#   0x80-0xFF  repeat the next byte (c - 0x80 + 3) times
+#
+# There is no header; the loader already knows the unpacked size.
+# See load_rle_xram() in src/blockout_assets.c for the decoder.
+
+import sys
+import argparse
+
+MIN_RUN = 3
+MAX_RUN = 0x7F + MIN_RUN
+MAX_LITERAL = 0x80
+
+
+def pack(data):
+    out = bytearray()
+    literal = bytearray()
+
+    def flush():
+        while literal:
+            chunk = literal[:MAX_LITERAL]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+            del literal[:MAX_LITERAL]
+
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < MAX_RUN and data[i + run] == data[i]:
+            run += 1
+        if run >= MIN_RUN:
+            flush()
+            out.append(0x80 + run - MIN_RUN)
+            out.append(data[i])
+            i += run
+        else:
+            literal.append(data[i])
+            i += 1
+    flush()
+    return bytes(out)
+
+
+def unpack(data, size):
+    out = bytearray()
+    i = 0
+    while len(out) < size:
+        c = data[i]
+        i += 1
+        if c < 0x80:
+            out.extend(data[i:i + c + 1])
+            i += c + 1
+        else:
+            out.extend(bytes([data[i]]) * (c - 0x80 + MIN_RUN))
+            i += 1
+    return bytes(out[:size])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RLE pack an image for load_rle_xram()")
+    parser.add_argument("input", help="raw image file")
+    parser.add_argument("output", help="packed output file")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        raw = f.read()
+    packed = pack(raw)
+    if unpack(packed, len(raw)) != raw:
+        sys.exit(f"{args.input}: round trip failed")
+    with open(args.output, "wb") as f:
+        f.write(packed)
+    print(f"{args.input}: {len(raw)} -> {len(packed)} bytes")
+
+
+if __name__ == "__main__":
+    main()
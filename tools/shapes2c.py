@@ -0,0 +1,278 @@
+#!/usr/bin/env python3
+#
+# Compile polycube definitions (shapes/shapes.txt) into C tables.
+#
+# For the chosen set this writes:
+#   shape_set.h   NUM_SHAPES, MAX_BLOCKS and MAX_VERTICES, included by
+#                 blockout_types.h
+#   shape_data.h  the shapes[] table, included by blockout_shapes.c only
+#
+# Each shape gets a rotation centre in half-blocks and its block offsets
+# in all 24 orientations, so the game turns a piece with a table lookup.
+# The wireframe is compiled to one list of unique corners and one of
+# unique outer edges: only creases of the solid are kept, so seams
+# between blocks are dropped while concave corners are drawn. Corners
+# and edges shared by several blocks appear once, and collinear
+# edges that meet at an otherwise unused corner are joined. The
+# orientation order, cube corners and cube edges are read from
+# src/blockout_math.c.
+#
+# Usage: shapes2c.py shapes/shapes.txt src/blockout_math.c basic out_dir
+
+import os
+import re
+import sys
+import argparse
+
+MIN_PIT = 3
+NUM_ORIENTS = 24
+
+# Face neighbours
+FACES = [(1, 0, 0), (-1, 0, 0), (0, 1, 0), (0, -1, 0), (0, 0, 1), (0, 0, -1)]
+
+
+def parse_sets(lines):
+    sets = {}
+    current = None
+    for lineno, line in enumerate(lines, 1):
+        toks = line.split("#", 1)[0].split()
+        if not toks:
+            continue
+        try:
+            if toks[0] == "set":
+                current = []
+                if len(toks) > 2:
+                    current += sets[toks[2]]
+                sets[toks[1]] = current
+                continue
+            if current is None:
+                raise ValueError("shape before the first set")
+            center = None
+            if toks[-1].startswith("@"):
+                center = [int(v) for v in toks.pop()[1:].split(",")]
+                if len(center) != 3:
+                    raise ValueError("a centre is @x,y,z")
+            cubes = [tuple(int(v) for v in t.split(",")) for t in toks[1:]]
+            if any(len(c) != 3 for c in cubes):
+                raise ValueError("cubes are x,y,z")
+            current.append((toks[0], cubes, center))
+        except (ValueError, KeyError) as e:
+            sys.exit(f"line {lineno}: {e}")
+    return sets
+
+
+def parse_table(path, text, name):
+    m = re.search(name + r"\[[^=]*=\s*\{(.*?)\};", text, re.S)
+    if not m:
+        sys.exit(f"{path}: {name} not found")
+    return m.group(1)
+
+
+def parse_math(path):
+    text = open(path).read()
+    rows = re.findall(r"\{\s*(-?\d+),\s*(-?\d+),\s*(-?\d+)\s*\}",
+                      parse_table(path, text, "orient_axes"))
+    if len(rows) != NUM_ORIENTS:
+        sys.exit(f"{path}: expected {NUM_ORIENTS} orientations")
+    axes = [tuple(int(v) for v in r) for r in rows]
+
+    # Corners as signs, (-1,-1,-1) for {-UNIT_SCALE,-UNIT_SCALE,-UNIT_SCALE}
+    rows = re.findall(r"\{([^{}]*)\}", parse_table(path, text, "ref_vertices"))
+    corners = [tuple(-1 if "-" in v else 1 for v in r.split(",")) for r in rows]
+    vals = [int(v) for v in re.findall(r"\d+", parse_table(path, text, "edges"))]
+    edges = list(zip(vals[0::2], vals[1::2]))
+    if len(corners) != 8 or len(edges) != 12:
+        sys.exit(f"{path}: expected 8 cube corners and 12 edges")
+    return axes, corners, edges
+
+
+def check_shape(name, cubes):
+    if len(set(cubes)) != len(cubes):
+        sys.exit(f"{name}: duplicate cube")
+    # Connected through faces
+    seen = {cubes[0]}
+    todo = [cubes[0]]
+    while todo:
+        c = todo.pop()
+        for d in FACES:
+            n = (c[0] + d[0], c[1] + d[1], c[2] + d[2])
+            if n in cubes and n not in seen:
+                seen.add(n)
+                todo.append(n)
+    if len(seen) != len(cubes):
+        sys.exit(f"{name}: cubes are not connected")
+    for i in range(3):
+        vals = [c[i] for c in cubes]
+        if max(vals) - min(vals) >= MIN_PIT:
+            sys.exit(f"{name}: wider than the smallest pit")
+    if min(c[2] for c in cubes) < 0:
+        sys.exit(f"{name}: cubes above z = 0 cannot spawn")
+
+
+def wireframe(cubes, corners, edges):
+    # Corners are keyed by doubled lattice position. Each unique corner
+    # keeps the first (block << 3) | corner that reaches it, so the game
+    # places it exactly as it placed that block's corner.
+    points = {}
+    vertices = []
+    lines = set()
+    for b, c in enumerate(cubes):
+        for v0, v1 in edges:
+            a, z = corners[v0], corners[v1]
+            # Four cells meet at an edge, this block's among them. It is a
+            # crease, and drawn, unless all are full or two side by side
+            # make it flat.
+            i, j = [k for k in range(3) if a[k] == z[k]]
+            cells = []
+            for di, dj in ((0, 0), (a[i], 0), (0, a[j]), (a[i], a[j])):
+                n = list(c)
+                n[i] += di
+                n[j] += dj
+                cells.append(tuple(n) in cubes)
+            if cells in ([True, True, False, False], [True, False, True, False],
+                         [True, True, True, True]):
+                continue
+            ends = []
+            for v in (v0, v1):
+                key = tuple(c[i] * 2 + corners[v][i] for i in range(3))
+                if key not in points:
+                    points[key] = len(vertices)
+                    vertices.append((b << 3) | v)
+                ends.append(points[key])
+            lines.add(tuple(sorted(ends)))
+
+    # A corner between two collinear edges and nothing else is just a
+    # point on a longer line: join the edges and drop the corner.
+    pos = {i: k for k, i in points.items()}
+    merged = True
+    while merged:
+        merged = False
+        for p in list(pos):
+            ends = [e for e in lines if p in e]
+            if len(ends) != 2:
+                continue
+            a, z = [e[0] if e[1] == p else e[1] for e in ends]
+            da = [pos[a][i] - pos[p][i] for i in range(3)]
+            dz = [pos[z][i] - pos[p][i] for i in range(3)]
+            cross = (da[1] * dz[2] - da[2] * dz[1], da[2] * dz[0] - da[0] * dz[2],
+                     da[0] * dz[1] - da[1] * dz[0])
+            if cross != (0, 0, 0):
+                continue
+            lines -= set(ends)
+            lines.add(tuple(sorted((a, z))))
+            del pos[p]
+            merged = True
+
+    keep = sorted(pos)
+    index = {old: new for new, old in enumerate(keep)}
+    return ([vertices[i] for i in keep],
+            sorted(tuple(sorted((index[a], index[z]))) for a, z in lines))
+
+
+def rotation_center(name, cubes, given):
+    # Bounding box centre in half-blocks, unless the shape names its own.
+    # Doubled coordinates must share one parity on every axis, or a turn
+    # would land between cells; the odd axes out are nudged by half a
+    # block.
+    if given is not None:
+        if len({v & 1 for v in given}) != 1:
+            sys.exit(f"{name}: centre {fmt3(given)} mixes whole and half blocks")
+        return given
+    c = [min(v[i] for v in cubes) + max(v[i] for v in cubes) for i in range(3)]
+    parity = 1 if sum(v & 1 for v in c) >= 2 else 0
+    return [v if (v & 1) == parity else v + 1 for v in c]
+
+
+def rotate(cube, center, axes):
+    v = [cube[i] * 2 - center[i] for i in range(3)]
+    out = []
+    for i, a in enumerate(axes):
+        r = v[a - 1] if a > 0 else -v[-a - 1]
+        out.append((r + center[i]) // 2)
+    return out
+
+
+def fmt3(v):
+    return "{" + ",".join(str(x) for x in v) + "}"
+
+
+def write_if_changed(path, text):
+    if os.path.exists(path) and open(path).read() == text:
+        return
+    with open(path, "w") as f:
+        f.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile polycube sets")
+    parser.add_argument("input")
+    parser.add_argument("math", help="src/blockout_math.c, for orient_axes")
+    parser.add_argument("set", help="shape set to compile")
+    parser.add_argument("out_dir")
+    args = parser.parse_args()
+
+    sets = parse_sets(open(args.input).read().splitlines())
+    if args.set not in sets:
+        sys.exit(f"unknown set '{args.set}', have: {' '.join(sets)}")
+    shapes = sets[args.set]
+    axes, corners, edges = parse_math(args.math)
+    max_blocks = max(len(c) for _, c, _ in shapes)
+    src = os.path.basename(args.input)
+
+    offsets = []
+    vertex_data = []
+    edge_data = []
+    max_vertices = 0
+    entries = []
+    for name, cubes, given in shapes:
+        check_shape(name, cubes)
+        center = rotation_center(name, cubes, given)
+        base = len(offsets)
+        for orient in axes:
+            offsets += [rotate(c, center, orient) for c in cubes]
+        vertices, lines = wireframe(cubes, corners, edges)
+        max_vertices = max(max_vertices, len(vertices))
+        entries.append(
+            f'    {{{len(cubes)}, "{name}",\n'
+            f'        {{{", ".join(fmt3(c) for c in cubes)}}},\n'
+            f'        {fmt3(center)},\n'
+            f'        &shape_orient_offsets[{base}],\n'
+            f'        {len(vertices)}, {len(lines)}, '
+            f'&shape_vertices[{len(vertex_data)}], &shape_edges[{len(edge_data)}]}},\n')
+        vertex_data += vertices
+        edge_data += lines
+
+    set_h = (f"// Generated by tools/shapes2c.py from shapes/{src}, do not edit.\n"
+             "#ifndef SHAPE_SET_H\n#define SHAPE_SET_H\n\n"
+             f"// Shape set '{args.set}'\n"
+             f"#define NUM_SHAPES {len(shapes)}\n"
+             f"#define MAX_BLOCKS {max_blocks}\n"
+             f"#define MAX_VERTICES {max_vertices}\n\n"
+             "#endif\n")
+
+    def table(items, fmt, per_row):
+        return "\n".join("    " + ", ".join(fmt(v) for v in items[i:i + per_row]) + ","
+                         for i in range(0, len(items), per_row))
+
+    data_h = (f"// Generated by tools/shapes2c.py from shapes/{src}, do not edit.\n"
+              "#ifndef SHAPE_DATA_H\n#define SHAPE_DATA_H\n\n"
+              "// Included by blockout_shapes.c after blockout_types.h\n\n"
+              "// Block offsets per shape, orientation-major\n"
+              f"static const int8_t shape_orient_offsets[{len(offsets)}][3] = {{\n"
+              + table(offsets, fmt3, 6) + "\n};\n\n"
+              "// Wireframe corners, (block << 3) | cube corner\n"
+              f"static const uint8_t shape_vertices[{len(vertex_data)}] = {{\n"
+              + table(vertex_data, str, 12) + "\n};\n\n"
+              "// Wireframe edges, pairs of indices into the shape's corners\n"
+              f"static const uint8_t shape_edges[{len(edge_data)}][2] = {{\n"
+              + table(edge_data, lambda e: "{%d,%d}" % e, 8) + "\n};\n\n"
+              "const Shape shapes[NUM_SHAPES] = {\n"
+              + "".join(entries) + "};\n\n#endif\n")
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    write_if_changed(os.path.join(args.out_dir, "shape_set.h"), set_h)
+    write_if_changed(os.path.join(args.out_dir, "shape_data.h"), data_h)
+
+
+if __name__ == "__main__":
+    main()
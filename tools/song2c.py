@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+#
+# Compile a text song into an ezpsg byte stream (see src/ezpsg.h).
+#
+#   inst N        select instrument N (0-15)
+#   NOTE:DUR      play a note, e.g. c4:2 cs4:2 bb3:4; notes on one line
+#                 before a wait sound together
+#   wait N        wait N duration units (1-127)
+#   mark          loop mark
+#   loop N        jump back to the mark N times, 0 forever
+#   # ...         comment
+#
+# Usage: song2c.py music/theme.song out_dir/music_theme.h theme_song
+
+import os
+import re
+import sys
+import argparse
+
+NOTE_RE = re.compile(r"^([a-g])(s|b)?([0-8]):(\d+)$")
+SEMITONES = {"c": 0, "d": 2, "e": 4, "f": 5, "g": 7, "a": 9, "b": 11}
+
+
+def note_index(name, accidental, octave):
+    # Same numbering as enum ezpsg_notes: a0 = 0, c1 = 3, c8 = 87
+    n = int(octave) * 12 + SEMITONES[name] - 9
+    if accidental == "s":
+        n += 1
+    elif accidental == "b":
+        n -= 1
+    if not 0 <= n <= 87:
+        raise ValueError(f"note out of range: {name}{accidental or ''}{octave}")
+    return n
+
+
+def byte_arg(tok, lo, hi, what):
+    v = int(tok, 0)
+    if not lo <= v <= hi:
+        raise ValueError(f"{what} must be {lo}-{hi}")
+    return v
+
+
+def compile_song(lines):
+    out = []
+    for lineno, line in enumerate(lines, 1):
+        line = line.split("#", 1)[0]
+        toks = line.split()
+        i = 0
+        try:
+            while i < len(toks):
+                tok = toks[i].lower()
+                if tok == "inst":
+                    out.append(0xE0 + byte_arg(toks[i + 1], 0, 15, "instrument"))
+                    i += 2
+                elif tok == "wait":
+                    out.append(byte_arg(toks[i + 1], 1, 127, "wait"))
+                    i += 2
+                elif tok == "mark":
+                    out.append(0xF0)
+                    i += 1
+                elif tok == "loop":
+                    out += [0xF1, byte_arg(toks[i + 1], 0, 255, "loop count")]
+                    i += 2
+                else:
+                    m = NOTE_RE.match(tok)
+                    if not m:
+                        raise ValueError(f"unknown token '{toks[i]}'")
+                    dur = byte_arg(m.group(4), 1, 255, "duration")
+                    out += [0x80 + note_index(m.group(1), m.group(2), m.group(3)), dur]
+                    i += 1
+        except (ValueError, IndexError) as e:
+            sys.exit(f"line {lineno}: {e}")
+    out.append(0x00)
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile a text song for ezpsg")
+    parser.add_argument("input")
+    parser.add_argument("output")
+    parser.add_argument("name", help="C array name")
+    args = parser.parse_args()
+
+    with open(args.input) as f:
+        data = compile_song(f.readlines())
+
+    guard = re.sub(r"\W", "_", os.path.basename(args.output)).upper()
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, "w") as o:
+        o.write(f"// Generated by tools/song2c.py from music/{os.path.basename(args.input)}, do not edit.\n")
+        o.write(f"#ifndef {guard}\n#define {guard}\n\n#include <stdint.h>\n\n")
+        o.write(f"static const uint8_t {args.name}[{len(data)}] = {{\n")
+        for k in range(0, len(data), 12):
+            o.write("    " + ", ".join(f"0x{b:02X}" for b in data[k:k + 12]) + ",\n")
+        o.write(f"}};\n\n#endif\n")
+    print(f"{os.path.basename(args.input)}: {len(data)} bytes")
+
+
+if __name__ == "__main__":
+    main()
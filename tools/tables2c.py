@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+#
+# Generate the projection tables the game would otherwise compute at
+# startup or on a pit resize, as const data in ROM:
+#
+#   persp_lut        65536 / z, the perspective scale per depth
+#   quarter_squares  n * n / 4, for apply_perspective_fast
+#   grid_cell_sizes  cell size in world units by the pit's wider side
+#   grid_axes        screen coordinates of every grid line on every layer,
+#                    one entry per (pit extent, wider side) pair
+#
+# The oblique grid is built at run time by build_oblique_tables(); its
+# extent is checked here for every pit size so none can leave the
+# viewport.
+#
+# The viewport and pit limits are read from src/blockout_types.h. The
+# arithmetic mirrors apply_perspective and must stay in step with it.
+#
+# Usage: tables2c.py src/blockout_types.h out_dir/math_tables.h
+
+import os
+import re
+import sys
+import argparse
+
+NEEDED = ("VIEWPORT_WIDTH", "VIEWPORT_HEIGHT", "PIT_Z_START", "PIT_Z_STEP",
+          "MIN_PIT_WIDTH", "MIN_PIT_DEPTH", "MAX_PIT_WIDTH", "MAX_PIT_DEPTH",
+          "MIN_PIT_HEIGHT", "MAX_PIT_HEIGHT", "OBLIQUE_DEPTH_SHIFT")
+
+
+def parse_defines(path):
+    defs = {}
+    for m in re.finditer(r"^#define\s+(\w+)\s+(\d+)\b", open(path).read(), re.M):
+        defs[m.group(1)] = int(m.group(2))
+    missing = [n for n in NEEDED if n not in defs]
+    if missing:
+        sys.exit(f"{path}: missing {' '.join(missing)}")
+    return defs
+
+
+def c_div(a, b):
+    # C division truncates toward zero
+    q = abs(a) // abs(b)
+    return q if (a < 0) == (b < 0) else -q
+
+
+def check_oblique(d):
+    # Mirrors build_oblique_tables(): the far grid line of the shifted
+    # stack must land on a viewport pixel
+    last = d["VIEWPORT_WIDTH"] - 1
+    for span in range(d["MIN_PIT_WIDTH"], d["MAX_PIT_WIDTH"] + 1):
+        for n in range(d["MIN_PIT_WIDTH"], span + 1):
+            for h in range(d["MIN_PIT_HEIGHT"], d["MAX_PIT_HEIGHT"] + 1):
+                size = (4 * last) // (4 * span + h)
+                extent = n * size + ((h * size) >> d["OBLIQUE_DEPTH_SHIFT"])
+                if extent > last:
+                    sys.exit(f"oblique {n}x{span}x{h} pit spans {extent + 1} pixels, "
+                             f"over the viewport's {last + 1}")
+
+
+def table(values, per_row, fmt=str):
+    return "\n".join("    " + ", ".join(fmt(v) for v in values[i:i + per_row]) + ","
+                     for i in range(0, len(values), per_row))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate projection tables")
+    parser.add_argument("types", help="src/blockout_types.h")
+    parser.add_argument("output")
+    args = parser.parse_args()
+    d = parse_defines(args.types)
+
+    # x and y share one set of axis tables
+    if (d["VIEWPORT_WIDTH"] != d["VIEWPORT_HEIGHT"] or
+            d["MIN_PIT_WIDTH"] != d["MIN_PIT_DEPTH"] or
+            d["MAX_PIT_WIDTH"] != d["MAX_PIT_DEPTH"]):
+        sys.exit("the pit and viewport must be square for shared grid tables")
+    check_oblique(d)
+
+    # 65536 / z saturates to 65535 for z < 2
+    persp = [min(65536 // max(i, 1), 65535) for i in range(256)]
+    squares = [n * n // 4 for n in range(511)]
+
+    lo, hi = d["MIN_PIT_WIDTH"], d["MAX_PIT_WIDTH"]
+    center = d["VIEWPORT_WIDTH"] >> 1
+    sizes = [d["VIEWPORT_WIDTH"] // span if span >= lo else 0 for span in range(hi + 1)]
+
+    axes = []
+    index = []
+    for span in range(lo, hi + 1):
+        row = []
+        for n in range(lo, hi + 1):
+            if n > span:
+                row.append("0xFF")
+                continue
+            size = sizes[span]
+            origin = c_div(-(n * size), 2)
+            layers = []
+            for z in range(d["MAX_PIT_HEIGHT"] + 1):
+                zi = (d["PIT_Z_START"] + z * d["PIT_Z_STEP"]) & 0xFF
+                line = [(((i * size + origin) * persp[zi]) >> 10) + center & 0xFF
+                        for i in range(n + 1)]
+                layers.append("{" + ",".join(str(v) for v in line) + "}")
+            row.append(str(len(axes)))
+            axes.append(f"    // {n} cells of {size}\n    {{{origin}, {{\n"
+                        + table(layers, 4).replace("    ", "        ") + "\n    }},\n")
+        index.append("{" + ", ".join(row) + "}")
+
+    text = (f"// Generated by tools/tables2c.py from {os.path.basename(args.types)}, do not edit.\n"
+            "#ifndef MATH_TABLES_H\n#define MATH_TABLES_H\n\n"
+            "// Included by blockout_math.c only\n\n"
+            "const uint16_t persp_lut[256] = {\n" + table(persp, 12) + "\n};\n\n"
+            "const uint16_t quarter_squares[511] = {\n" + table(squares, 12) + "\n};\n\n"
+            f"const uint8_t grid_cell_sizes[{hi + 1}] = {{\n"
+            + table(sizes, 12) + "\n};\n\n"
+            f"static const GridAxis grid_axes[{len(axes)}] = {{\n" + "".join(axes) + "};\n\n"
+            "// grid_axes entry by [wider side - MIN][extent - MIN]\n"
+            f"static const uint8_t grid_axis_index[{hi - lo + 1}][{hi - lo + 1}] = {{\n"
+            + table(index, 1) + "\n};\n\n#endif\n")
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    if os.path.exists(args.output) and open(args.output).read() == text:
+        return
+    with open(args.output, "w") as f:
+        f.write(text)
+
+
+if __name__ == "__main__":
+    main()